@@ -0,0 +1,64 @@
+#include "CandidateLists.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace aco {
+
+CandidateLists::CandidateLists(const config::TtpConfig& ttpConfig, const uint32_t candidatesNum)
+	: candidatesNum(std::min(candidatesNum, static_cast<uint32_t>(ttpConfig.cities.size()) - 1))
+	, candidates(ttpConfig.cities.size() * this->candidatesNum)
+	, distances(ttpConfig.cities.size() * this->candidatesNum)
+{
+	const auto& cities = ttpConfig.cities;
+	std::vector<std::pair<double, uint32_t>> neighbours;
+	neighbours.reserve(cities.size());
+	for (auto i = 0u; i < cities.size(); i++)
+	{
+		neighbours.clear();
+		for (auto j = 0u; j < cities.size(); j++)
+		{
+			if (j != i)
+				neighbours.emplace_back(cities[i].getDistance(cities[j]), cities[j].index);
+		}
+		std::partial_sort(neighbours.begin(), neighbours.begin() + this->candidatesNum, neighbours.end());
+		for (auto k = 0u; k < this->candidatesNum; k++)
+		{
+			distances[i * this->candidatesNum + k] = neighbours[k].first;
+			candidates[i * this->candidatesNum + k] = neighbours[k].second;
+		}
+	}
+}
+
+uint32_t CandidateLists::getCandidatesNum() const
+{
+	return candidatesNum;
+}
+
+uint32_t CandidateLists::getOffset(const uint32_t cityId) const
+{
+	return (cityId - 1) * candidatesNum;
+}
+
+const std::vector<uint32_t>& CandidateLists::getCandidates() const
+{
+	return candidates;
+}
+
+const std::vector<double>& CandidateLists::getDistances() const
+{
+	return distances;
+}
+
+int32_t CandidateLists::findSlot(const uint32_t fromCityId, const uint32_t toCityId) const
+{
+	const auto offset = getOffset(fromCityId);
+	for (auto k = 0u; k < candidatesNum; k++)
+	{
+		if (candidates[offset + k] == toCityId)
+			return static_cast<int32_t>(offset + k);
+	}
+	return -1;
+}
+
+} // namespace aco
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <configuration/TtpConfig.hpp>
+
+namespace aco {
+
+// K nearest neighbours of every city in flat arrays, candidates of city with id c are at [(c - 1) * K, c * K),
+// sorted by distance ascending
+class CandidateLists
+{
+public:
+	CandidateLists(const config::TtpConfig& ttpConfig, const uint32_t candidatesNum);
+
+	CandidateLists() = delete;
+	CandidateLists(const CandidateLists&) = default;
+	CandidateLists(CandidateLists&&) = default;
+	~CandidateLists() = default;
+
+	CandidateLists& operator=(const CandidateLists&) = delete;
+	CandidateLists& operator=(CandidateLists&&) = delete;
+
+	uint32_t getCandidatesNum() const;
+	uint32_t getOffset(const uint32_t cityId) const;
+	const std::vector<uint32_t>& getCandidates() const;  // city ids
+	const std::vector<double>& getDistances() const;
+	int32_t findSlot(const uint32_t fromCityId, const uint32_t toCityId) const;  // -1 if toCityId is not a candidate
+
+private:
+	const uint32_t candidatesNum;
+	std::vector<uint32_t> candidates;
+	std::vector<double> distances;
+};
+
+} // namespace aco
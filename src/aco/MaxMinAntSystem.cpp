@@ -0,0 +1,223 @@
+#include "MaxMinAntSystem.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+
+#include <utils/Affinity.hpp>
+#include <utils/RandomUtils.hpp>
+#include <utils/ThreadPool.hpp>
+
+namespace aco {
+
+namespace {
+
+struct ConstructionScratch
+{
+	std::vector<uint32_t> unvisited;  // city ids, swap-removed
+	std::vector<uint32_t> positionInUnvisited;  // indexed by city id
+	std::vector<double> weights;  // of candidates
+};
+
+ConstructionScratch& getConstructionScratch()
+{
+	thread_local ConstructionScratch scratch;
+	return scratch;
+}
+
+constexpr uint32_t bestSoFarDepositInterval = 5u;
+constexpr uint64_t antsFirstStreamId = 1ull << 32;
+
+} // namespace
+
+MaxMinAntSystem::MaxMinAntSystem(const config::GAlgParams& params, const config::AcoParams& acoParams,
+	const config::TtpConfig& ttpConfig, logging::Logger& logger)
+	: params(params)
+	, acoParams(acoParams)
+	, ttpConfig(ttpConfig)
+	, threadsNum(params.threadsNum != 0 ? params.threadsNum : std::max(1u, std::thread::hardware_concurrency()))
+	, candidateLists(ttpConfig, acoParams.candidatesNum)
+	, tauMax(1.0 / acoParams.evaporationRate)  // equilibrium of unit deposit
+	, tauMin(tauMax / (2.0 * ttpConfig.cities.size()))
+	, pheromone(candidateLists.getCandidates().size(), tauMax)
+	, heuristic(candidateLists.getCandidates().size())
+	, choiceInfo(candidateLists.getCandidates().size())
+	, logger(logger)
+	, iterationsNum(0u)
+{
+	if (params.populationSize == 0)
+		throw std::runtime_error("Ants num (population size) can't be 0");
+	if (acoParams.candidatesNum == 0)
+		throw std::runtime_error("ACO candidates num can't be 0");
+	if (acoParams.evaporationRate <= 0.0 || acoParams.evaporationRate > 1.0)
+		throw std::runtime_error("ACO evaporation rate has to be in (0, 1]");
+	const auto& distances = candidateLists.getDistances();
+	for (auto i = 0u; i < distances.size(); i++)
+		heuristic[i] = std::pow(1.0 / std::max(distances[i], 1e-9), acoParams.beta);
+	updateChoiceInfo();
+	ants.resize(params.populationSize);
+}
+
+void MaxMinAntSystem::run()
+{
+	startTimestamp = SteadyClock::now();
+	constructSolutions();
+	setBestIndividualSoFar();
+	logState();
+	while (!checkStopConditions())
+	{
+		updatePheromone();
+		constructSolutions();
+		iterationsNum++;
+		setBestIndividualSoFar();
+		logState();
+	}
+}
+
+MaxMinAntSystem::IndividualPtr MaxMinAntSystem::getBestIndividual() const
+{
+	return std::make_unique<ttp::TtpIndividual>(*bestIndividualSoFar);
+}
+
+void MaxMinAntSystem::constructSolutions()
+{
+	auto constructAnts = [this](const uint32_t firstAnt, const uint32_t step) {
+		utils::affinity::pinCurrentThread(firstAnt);
+		for (auto ant = firstAnt; ant < ants.size(); ant += step)
+			ants[ant] = constructSolution(ant);
+	};
+	utils::runWorkers(std::min(threadsNum, static_cast<uint32_t>(ants.size())), constructAnts);
+}
+
+MaxMinAntSystem::IndividualPtr MaxMinAntSystem::constructSolution(const uint32_t antId) const
+{
+	utils::rnd::RandomEngine gen(utils::rnd::Random::getGlobalSeed(),
+		antsFirstStreamId + static_cast<uint64_t>(iterationsNum) * ants.size() + antId);
+	auto drawUnitDouble = [&gen]() {return static_cast<double>(gen() >> 11) * 0x1.0p-53; };
+
+	const auto citiesNum = static_cast<uint32_t>(ttpConfig.cities.size());
+	const auto candidatesNum = candidateLists.getCandidatesNum();
+	const auto& candidates = candidateLists.getCandidates();
+	auto& scratch = getConstructionScratch();
+	scratch.unvisited.resize(citiesNum);
+	std::iota(scratch.unvisited.begin(), scratch.unvisited.end(), 1u);
+	scratch.positionInUnvisited.resize(citiesNum + 1);
+	scratch.positionInUnvisited[0] = citiesNum;  // no city with id 0
+	std::iota(scratch.positionInUnvisited.begin() + 1, scratch.positionInUnvisited.end(), 0u);
+	scratch.weights.resize(candidatesNum);
+	auto markVisited = [&scratch, citiesNum](const uint32_t cityId) {
+		const auto pos = scratch.positionInUnvisited[cityId];
+		const auto lastCityId = scratch.unvisited.back();
+		scratch.unvisited[pos] = lastCityId;
+		scratch.positionInUnvisited[lastCityId] = pos;
+		scratch.unvisited.pop_back();
+		scratch.positionInUnvisited[cityId] = citiesNum;
+	};
+
+	std::vector<ttp::City> tour;
+	tour.reserve(citiesNum);
+	auto current = static_cast<uint32_t>(((gen() >> 32) * citiesNum) >> 32) + 1;
+	tour.push_back(ttpConfig.cities[current - 1]);
+	markVisited(current);
+	while (!scratch.unvisited.empty())
+	{
+		const auto offset = candidateLists.getOffset(current);
+		double weightsSum = 0.0;
+		for (auto k = 0u; k < candidatesNum; k++)
+		{
+			const bool isUnvisited = scratch.positionInUnvisited[candidates[offset + k]] != citiesNum;
+			scratch.weights[k] = isUnvisited ? choiceInfo[offset + k] : 0.0;
+			weightsSum += scratch.weights[k];
+		}
+		uint32_t next = 0u;
+		if (weightsSum > 0.0)
+		{
+			double threshold = drawUnitDouble() * weightsSum;
+			auto k = 0u;
+			for (; k + 1 < candidatesNum && threshold >= scratch.weights[k]; k++)
+				threshold -= scratch.weights[k];
+			while (scratch.weights[k] == 0.0)  // rounding may leave threshold past last unvisited candidate
+				k--;
+			next = candidates[offset + k];
+		}
+		else
+		{
+			const auto& from = ttpConfig.cities[current - 1];
+			next = *std::min_element(scratch.unvisited.cbegin(), scratch.unvisited.cend(), [this, &from](const auto lhs, const auto rhs) {
+				return from.getDistance(ttpConfig.cities[lhs - 1]) < from.getDistance(ttpConfig.cities[rhs - 1]); });
+		}
+		tour.push_back(ttpConfig.cities[next - 1]);
+		markVisited(next);
+		current = next;
+	}
+	auto individual = std::make_unique<ttp::TtpIndividual>(ttpConfig, ttp::TspSolution(ttpConfig, std::move(tour)));
+	individual->evaluate();
+	return individual;
+}
+
+void MaxMinAntSystem::updatePheromone()
+{
+	const double retained = 1.0 - acoParams.evaporationRate;
+	for (auto& tau : pheromone)
+		tau *= retained;
+	const bool depositBestSoFar = iterationsNum % bestSoFarDepositInterval == bestSoFarDepositInterval - 1;
+	const auto& depositing = depositBestSoFar ? *bestIndividualSoFar : **std::max_element(ants.cbegin(), ants.cend(),
+		[](const auto& lhs, const auto& rhs) {return lhs->getCurrentFitness() < rhs->getCurrentFitness(); });
+	depositOnTour(depositing.getCityChain(), 1.0);
+	for (auto& tau : pheromone)
+		tau = std::clamp(tau, tauMin, tauMax);
+	updateChoiceInfo();
+}
+
+void MaxMinAntSystem::depositOnTour(const std::vector<ttp::City>& tour, const double amount)
+{
+	// edges are undirected, so deposit goes to candidate slots on both ends
+	for (auto i = 0u; i < tour.size(); i++)
+	{
+		const auto from = tour[i].index;
+		const auto to = tour[i + 1 == tour.size() ? 0 : i + 1].index;
+		const auto forwardSlot = candidateLists.findSlot(from, to);
+		if (forwardSlot >= 0)
+			pheromone[forwardSlot] += amount;
+		const auto backwardSlot = candidateLists.findSlot(to, from);
+		if (backwardSlot >= 0)
+			pheromone[backwardSlot] += amount;
+	}
+}
+
+void MaxMinAntSystem::updateChoiceInfo()
+{
+	for (auto i = 0u; i < pheromone.size(); i++)
+		choiceInfo[i] = std::pow(pheromone[i], acoParams.alpha) * heuristic[i];
+}
+
+void MaxMinAntSystem::setBestIndividualSoFar()
+{
+	const auto& iterationBest = *std::max_element(ants.cbegin(), ants.cend(),
+		[](const auto& lhs, const auto& rhs) {return lhs->getCurrentFitness() < rhs->getCurrentFitness(); });
+	if (bestIndividualSoFar == nullptr)
+		bestIndividualSoFar = std::make_unique<ttp::TtpIndividual>(*iterationBest);
+	else if (iterationBest->getCurrentFitness() > bestIndividualSoFar->getCurrentFitness())
+		*bestIndividualSoFar = *iterationBest;
+}
+
+bool MaxMinAntSystem::checkStopConditions() const
+{
+	if (params.maxPopulationsNum != 0 && iterationsNum >= params.maxPopulationsNum)
+		return true;
+	return params.maxGAlgDuration != std::chrono::seconds::zero() && SteadyClock::now() - startTimestamp >= params.maxGAlgDuration;
+}
+
+void MaxMinAntSystem::logState() const
+{
+	auto bestWorstIterators = std::minmax_element(ants.cbegin(), ants.cend(),
+		[](const auto& lhs, const auto& rhs) {return lhs->getCurrentFitness() < rhs->getCurrentFitness(); });
+	double sumOfFitnesses = std::accumulate(ants.cbegin(), ants.cend(), 0.0,
+		[](const auto& acc, const auto& ant) {return acc + ant->getCurrentFitness(); });
+	logger.log("%d, %.4f, %.4f, %.4f", iterationsNum, (*bestWorstIterators.second)->getCurrentFitness(),
+		sumOfFitnesses / ants.size(), (*bestWorstIterators.first)->getCurrentFitness());
+}
+
+} // namespace aco
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "CandidateLists.hpp"
+#include <configuration/GAlgConfig.hpp>
+#include <configuration/TtpConfig.hpp>
+#include <logger/Logger.hpp>
+#include <ttp/TtpIndividual.hpp>
+
+namespace aco {
+
+// MAX-MIN ant system: every iteration populationSize ants build tours in parallel, choosing next city among
+// unvisited candidates with probability proportional to pheromone^alpha * distance^-beta, or the nearest unvisited city
+// when all candidates are visited. Tours are packed and evaluated by TtpIndividual. Pheromone lives only on candidate
+// edges, in arrays parallel to candidate lists; best ant of iteration (every few iterations best so far) deposits,
+// values are kept within [tauMin, tauMax].
+// Every ant has its own random stream, so results don't depend on threads num.
+class MaxMinAntSystem
+{
+public:
+	using IndividualPtr = std::unique_ptr<ttp::TtpIndividual>;
+
+	MaxMinAntSystem(const config::GAlgParams& params, const config::AcoParams& acoParams,
+		const config::TtpConfig& ttpConfig, logging::Logger& logger);
+
+	MaxMinAntSystem() = delete;
+	MaxMinAntSystem(const MaxMinAntSystem&) = delete;
+	MaxMinAntSystem(MaxMinAntSystem&&) = delete;
+	~MaxMinAntSystem() = default;
+
+	MaxMinAntSystem& operator=(const MaxMinAntSystem&) = delete;
+	MaxMinAntSystem& operator=(MaxMinAntSystem&&) = delete;
+
+	void run();
+	IndividualPtr getBestIndividual() const;
+
+private:
+	using SteadyClock = std::chrono::steady_clock;
+
+	void constructSolutions();
+	IndividualPtr constructSolution(const uint32_t antId) const;
+	void updatePheromone();
+	void depositOnTour(const std::vector<ttp::City>& tour, const double amount);
+	void updateChoiceInfo();
+	void setBestIndividualSoFar();
+	bool checkStopConditions() const;
+	void logState() const;
+
+	const config::GAlgParams params;
+	const config::AcoParams acoParams;
+	const config::TtpConfig& ttpConfig;
+	const uint32_t threadsNum;
+	const CandidateLists candidateLists;
+	const double tauMax;
+	const double tauMin;
+
+	// parallel to candidate lists
+	std::vector<double> pheromone;
+	std::vector<double> heuristic;
+	std::vector<double> choiceInfo;
+
+	std::vector<IndividualPtr> ants;
+	IndividualPtr bestIndividualSoFar;
+	logging::Logger& logger;
+	uint32_t iterationsNum;
+	SteadyClock::time_point startTimestamp;
+};
+
+} // namespace aco
@@ -0,0 +1,166 @@
+#include "TtpSolver.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include <configuration/TtpConfig.hpp>
+#include <ga/GAlg.hpp>
+#include <logger/Logger.hpp>
+#include <naive/GreedyAlg.hpp>
+#include <naive/RandomSelectionAlg.hpp>
+#include <ttp/TtpIndividual.hpp>
+#include <utils/RandomUtils.hpp>
+
+namespace api {
+
+namespace {
+
+using IndividualPtr = std::unique_ptr<ttp::TtpIndividual>;
+using SteadyClock = std::chrono::steady_clock;
+
+config::TtpConfig makeTtpConfig(const InstanceData& data)
+{
+	if (data.citiesNum < 2)
+		throw std::runtime_error("Instance needs at least 2 cities");
+	if (data.cityXs == nullptr || data.cityYs == nullptr)
+		throw std::runtime_error("City coordinates not provided");
+	if (data.itemsNum != 0 && (data.itemProfits == nullptr || data.itemWeights == nullptr || data.itemCityIds == nullptr))
+		throw std::runtime_error("Item data not provided");
+	if (data.capacityOfKnapsack == 0)
+		throw std::runtime_error("Capacity of knapsack can't be 0");
+	if (data.minVelocity <= 0.0 || data.maxVelocity < data.minVelocity)
+		throw std::runtime_error("Velocities have to satisfy 0 < min velocity <= max velocity");
+
+	config::TtpConfig ttpConfig;
+	ttpConfig.problemName = "api";
+	ttpConfig.knapsackDataType = "api";
+	ttpConfig.dimenssion = data.citiesNum;
+	ttpConfig.itemsNum = data.itemsNum;
+	ttpConfig.capacityOfKnapsack = data.capacityOfKnapsack;
+	ttpConfig.minVelocity = data.minVelocity;
+	ttpConfig.maxVelocity = data.maxVelocity;
+	ttpConfig.rentingRatio = data.rentingRatio;
+	ttpConfig.cities.reserve(data.citiesNum);
+	for (auto i = 0u; i < data.citiesNum; i++)
+		ttpConfig.cities.push_back(ttp::City{ i + 1, data.cityXs[i], data.cityYs[i] });
+	ttpConfig.items.reserve(data.itemsNum);
+	for (auto i = 0u; i < data.itemsNum; i++)
+	{
+		if (data.itemCityIds[i] == 0 || data.itemCityIds[i] > data.citiesNum)
+			throw std::runtime_error("Item " + std::to_string(i + 1) + " lies in nonexistent city " + std::to_string(data.itemCityIds[i]));
+		ttpConfig.items.push_back(ttp::Item{ i + 1, data.itemProfits[i], data.itemWeights[i], data.itemCityIds[i] });
+	}
+	ttpConfig.fillNearestDistanceLookup();
+	ttpConfig.fillRankedItemsPerCity();
+	return ttpConfig;
+}
+
+config::GAlgParams makeGAlgParams(const SolveOptions& options)
+{
+	if (options.deadline == std::chrono::seconds::zero() && options.maxGenerations == 0)
+		throw std::runtime_error("GA needs deadline or generations limit");
+	config::GAlgParams params;
+	params.populationSize = options.populationSize;
+	params.selectionStrategy = options.selectionStrategy;
+	params.tournamentSize = options.tournamentSize;
+	params.maxPopulationsNum = options.maxGenerations;
+	params.maxGAlgDuration = options.deadline;
+	params.crossoverProb = options.crossoverProb;
+	params.mutationProb = options.mutationProb;
+	params.crossoverType = options.crossoverType;
+	params.elitismSize = options.elitismSize;
+	return params;
+}
+
+IndividualPtr runGAlg(const config::TtpConfig& ttpConfig, const SolveOptions& options, const ImprovementCallback& callback)
+{
+	auto createRandomFun = [&ttpConfig]() {
+		return ttp::TtpIndividual::createRandom(ttpConfig, utils::rnd::Random::getInstance().getRndGen()); };
+	logging::Logger logger(options.logFilePath);
+	ga::GAlg<ttp::TtpIndividual> gAlg(makeGAlgParams(options), createRandomFun, logger);
+	if (callback)
+	{
+		const auto startTimestamp = SteadyClock::now();
+		gAlg.setImprovementCallback([&callback, &gAlg, startTimestamp](const ttp::TtpIndividual& best, const uint32_t populationsNum) {
+			const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(SteadyClock::now() - startTimestamp);
+			if (!callback(Progress{ populationsNum, elapsed, best.getCurrentFitness() }))
+				gAlg.requestStop();
+		});
+	}
+	gAlg.run();
+	return gAlg.getBestIndividual();
+}
+
+IndividualPtr runNaiveAlg(const config::TtpConfig& ttpConfig, const SolveOptions& options)
+{
+	if (options.naiveRepetitions == 0)
+		throw std::runtime_error("Naive repetitions can't be 0");
+	if (options.algorithm == Algorithm::greedy)
+		return naive::GreedyAlg<ttp::TtpIndividual>(options.naiveRepetitions, ttpConfig).executeAlg();
+	auto createRandomFun = [&ttpConfig]() {
+		return ttp::TtpIndividual::createRandom(ttpConfig, utils::rnd::Random::getInstance().getRndGen()); };
+	return naive::RandomSelectionAlg<ttp::TtpIndividual>(options.naiveRepetitions, createRandomFun).executeAlg();
+}
+
+Solution makeSolution(const ttp::TtpIndividual& individual)
+{
+	// trip time is taken from the evaluation behind fitness, recomputing it would differ under single precision
+	Solution solution;
+	solution.fitness = individual.getCurrentFitness();
+	solution.profit = individual.getKnapsack().getKnapsackValue();
+	solution.tripTime = solution.profit - solution.fitness;
+	const auto& cityChain = individual.getCityChain();
+	solution.tour.reserve(cityChain.size());
+	for (const auto& city : cityChain)
+		solution.tour.push_back(city.index);
+	for (const auto& item : individual.getKnapsack().getItems())
+		solution.packedItems.push_back(item.index);
+	std::sort(solution.packedItems.begin(), solution.packedItems.end());
+	return solution;
+}
+
+} // namespace
+
+Instance::Instance(const InstanceData& data)
+	: ttpConfig(std::make_unique<const config::TtpConfig>(makeTtpConfig(data)))
+{
+}
+
+Instance::~Instance() = default;
+
+uint32_t Instance::getCitiesNum() const
+{
+	return static_cast<uint32_t>(ttpConfig->cities.size());
+}
+
+uint32_t Instance::getItemsNum() const
+{
+	return static_cast<uint32_t>(ttpConfig->items.size());
+}
+
+void setGlobalSeed(const uint64_t seed)
+{
+	utils::rnd::Random::setGlobalSeed(seed);
+}
+
+Solution solve(const Instance& instance, const SolveOptions& options, ImprovementCallback callback)
+{
+	// precision is a run setting kept in TtpConfig, so single precision solves work on their own copy
+	const config::TtpConfig* ttpConfig = instance.ttpConfig.get();
+	std::unique_ptr<config::TtpConfig> singlePrecisionConfig;
+	if (options.singlePrecision)
+	{
+		singlePrecisionConfig = std::make_unique<config::TtpConfig>(*instance.ttpConfig);
+		singlePrecisionConfig->evaluationPrecision = config::EvaluationPrecision::singlePrecision;
+		ttpConfig = singlePrecisionConfig.get();
+	}
+	utils::rnd::Random::getInstance().useStream(options.randomStream);
+	if (options.algorithm == Algorithm::ga)
+		return makeSolution(*runGAlg(*ttpConfig, options, callback));
+	const auto best = runNaiveAlg(*ttpConfig, options);
+	if (callback)
+		callback(Progress{ 0u, std::chrono::milliseconds::zero(), best->getCurrentFitness() });
+	return makeSolution(*best);
+}
+
+} // namespace api
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace config {
+struct TtpConfig;
+} // namespace config
+
+// Embedding API of ttp_ga_lib: depends only on standard library, solver internals stay behind Instance.
+namespace api {
+
+// Caller-owned arrays, read only while Instance is constructed. City at position k gets id k + 1,
+// item at position k gets index k + 1 and lies in city with id itemCityIds[k].
+struct InstanceData
+{
+	const double* cityXs;
+	const double* cityYs;
+	uint32_t citiesNum;
+	const uint32_t* itemProfits;
+	const uint32_t* itemWeights;
+	const uint32_t* itemCityIds;
+	uint32_t itemsNum;
+	uint32_t capacityOfKnapsack;
+	double minVelocity;
+	double maxVelocity;
+	double rentingRatio;
+};
+
+enum class Algorithm
+{
+	ga,
+	greedy,  // nearest neighbour tours, repeated naiveRepetitions times
+	randomSelection  // random tours, repeated naiveRepetitions times
+};
+
+struct SolveOptions
+{
+	Algorithm algorithm = Algorithm::ga;
+	std::chrono::seconds deadline = std::chrono::seconds::zero();  // 0 indicates no time limit, GA only
+	uint32_t maxGenerations = 1000u;  // 0 indicates no generations limit, GA only
+	uint32_t populationSize = 1000u;
+	std::string selectionStrategy = "tournament";
+	uint32_t tournamentSize = 90u;
+	double crossoverProb = 0.35;
+	double mutationProb = 0.4;
+	std::string crossoverType = "nrx";  // one of: nrx, pmx, ox, cx, erx
+	uint32_t elitismSize = 0u;
+	uint32_t naiveRepetitions = 10u;
+	uint64_t randomStream = 0u;  // solves with the same stream and global seed give the same result
+	bool singlePrecision = false;  // float trip time evaluation, see EVALUATION PRECISION
+	std::string logFilePath;  // per generation CSV as written by ttp_ga, empty disables
+};
+
+struct Progress
+{
+	uint32_t generation;
+	std::chrono::milliseconds elapsed;
+	double fitness;
+};
+
+// called from solving thread on every new best solution, returning false stops the solve after current generation
+using ImprovementCallback = std::function<bool(const Progress& progress)>;
+
+struct Solution
+{
+	double fitness;
+	double profit;
+	double tripTime;
+	std::vector<uint32_t> tour;  // city ids in visiting order
+	std::vector<uint32_t> packedItems;  // item indices, ascending
+};
+
+// Validated instance in solver layout with its lookup tables; immutable, may be shared by concurrent solves
+class Instance
+{
+public:
+	explicit Instance(const InstanceData& data);
+
+	Instance() = delete;
+	Instance(const Instance&) = delete;
+	Instance(Instance&&) = delete;
+	~Instance();
+
+	Instance& operator=(const Instance&) = delete;
+	Instance& operator=(Instance&&) = delete;
+
+	uint32_t getCitiesNum() const;
+	uint32_t getItemsNum() const;
+
+private:
+	friend Solution solve(const Instance& instance, const SolveOptions& options, ImprovementCallback callback);
+
+	std::unique_ptr<const config::TtpConfig> ttpConfig;
+};
+
+void setGlobalSeed(const uint64_t seed);  // process wide, 0 is a valid seed here
+Solution solve(const Instance& instance, const SolveOptions& options, ImprovementCallback callback = nullptr);
+
+} // namespace api
@@ -0,0 +1,174 @@
+#include "AnytimeBenchmark.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+
+#include <ga/GAlg.hpp>
+#include <naive/GreedyAlg.hpp>
+#include <naive/RandomSelectionAlg.hpp>
+#include <ttp/TtpIndividual.hpp>
+#include <utils/RandomUtils.hpp>
+
+namespace benchmark {
+
+namespace {
+
+using SteadyClock = std::chrono::steady_clock;
+
+double getSecondsSince(const SteadyClock::time_point start)
+{
+	return std::chrono::duration<double>(SteadyClock::now() - start).count();
+}
+
+} // namespace
+
+AnytimeBenchmark::AnytimeBenchmark(const config::BenchmarkConfig& benchmarkConfig, const config::GAlgConfig& gAlgConfig,
+	const std::vector<config::TtpConfig>& instances)
+	: benchmarkConfig(benchmarkConfig)
+	, gAlgConfig(gAlgConfig)
+	, instances(instances)
+	, anytimeLogger(benchmarkConfig.resultsCsvPrefix + "anytime.csv")
+	, timeToTargetLogger(benchmarkConfig.resultsCsvPrefix + "ttt.csv")
+{
+	if (instances.empty() || instances.size() != benchmarkConfig.instanceFilePaths.size())
+		throw std::runtime_error("Benchmark needs one loaded instance per benchmark instance path");
+	if (benchmarkConfig.runsNum == 0)
+		throw std::runtime_error("Benchmark runs num can't be 0");
+	if (benchmarkConfig.runDuration == std::chrono::seconds::zero())
+		throw std::runtime_error("Benchmark run duration can't be 0");
+	if (benchmarkConfig.samplingInterval <= std::chrono::milliseconds::zero())
+		throw std::runtime_error("Benchmark sampling interval has to be positive");
+}
+
+void AnytimeBenchmark::run()
+{
+	anytimeLogger.log("%s", "instance, algorithm, time ms, runs with solution, mean best fitness, min best fitness, max best fitness");
+	timeToTargetLogger.log("%s", "instance, algorithm, target gap, target fitness, run, time to target ms");
+	const std::vector<std::string> algorithmNames{ "ga", "greedy", "random" };
+	for (auto i = 0u; i < instances.size(); i++)
+	{
+		const auto& instanceName = benchmarkConfig.instanceFilePaths[i];
+		std::vector<std::vector<Trace>> traces(algorithmNames.size());
+		for (auto runId = 0u; runId < benchmarkConfig.runsNum; runId++)
+		{
+			// the same stream for every algorithm of a run
+			utils::rnd::Random::getInstance().useStream(runId + 1);
+			traces[0].push_back(runGAlg(instances[i]));
+			utils::rnd::Random::getInstance().useStream(runId + 1);
+			traces[1].push_back(runNaiveAlg(instances[i], true));
+			utils::rnd::Random::getInstance().useStream(runId + 1);
+			traces[2].push_back(runNaiveAlg(instances[i], false));
+			std::cout << instanceName << ": run " << runId + 1 << " of " << benchmarkConfig.runsNum << " done" << std::endl;
+		}
+
+		double referenceFitness = -std::numeric_limits<double>::infinity();
+		for (const auto& algorithmTraces : traces)
+		{
+			for (const auto& trace : algorithmTraces)
+			{
+				if (!trace.empty())
+					referenceFitness = std::max(referenceFitness, trace.back().fitness);
+			}
+		}
+		for (auto algorithm = 0u; algorithm < algorithmNames.size(); algorithm++)
+		{
+			logAnytimeCurve(instanceName, algorithmNames[algorithm], traces[algorithm]);
+			logTimesToTarget(instanceName, algorithmNames[algorithm], traces[algorithm], referenceFitness);
+		}
+	}
+}
+
+AnytimeBenchmark::Trace AnytimeBenchmark::runGAlg(const config::TtpConfig& ttpConfig) const
+{
+	auto params = gAlgConfig.gAlgParams;
+	params.maxPopulationsNum = 0u;
+	params.maxGAlgDuration = benchmarkConfig.runDuration;
+	Trace trace;
+	const auto start = SteadyClock::now();
+	auto createRandomFun = [&ttpConfig]() {
+		return ttp::TtpIndividual::createRandom(ttpConfig, utils::rnd::Random::getInstance().getRndGen()); };
+	logging::Logger logger("");  // per generation log isn't kept
+	ga::GAlg<ttp::TtpIndividual> gAlg(params, createRandomFun, logger);
+	gAlg.setImprovementCallback([&trace, start](const ttp::TtpIndividual& best, const uint32_t) {
+		trace.push_back(TracePoint{ getSecondsSince(start), best.getCurrentFitness() }); });
+	gAlg.run();
+	return trace;
+}
+
+AnytimeBenchmark::Trace AnytimeBenchmark::runNaiveAlg(const config::TtpConfig& ttpConfig, const bool isGreedy) const
+{
+	// repetitions are run one by one, so that every improvement gets its timestamp
+	Trace trace;
+	const auto start = SteadyClock::now();
+	const double maxSeconds = std::chrono::duration<double>(benchmarkConfig.runDuration).count();
+	auto createRandomFun = [&ttpConfig]() {
+		return ttp::TtpIndividual::createRandom(ttpConfig, utils::rnd::Random::getInstance().getRndGen()); };
+	for (auto repetition = 0u; repetition < gAlgConfig.naiveRepetitions && getSecondsSince(start) < maxSeconds; repetition++)
+	{
+		const auto individual = isGreedy ? naive::GreedyAlg<ttp::TtpIndividual>(1u, ttpConfig).executeAlg()
+			: naive::RandomSelectionAlg<ttp::TtpIndividual>(1u, createRandomFun).executeAlg();
+		if (trace.empty() || individual->getCurrentFitness() > trace.back().fitness)
+			trace.push_back(TracePoint{ getSecondsSince(start), individual->getCurrentFitness() });
+	}
+	return trace;
+}
+
+void AnytimeBenchmark::logAnytimeCurve(const std::string& instanceName, const std::string& algorithmName, const std::vector<Trace>& traces)
+{
+	const auto samplingIntervalMs = benchmarkConfig.samplingInterval.count();
+	const auto durationMs = std::chrono::duration_cast<std::chrono::milliseconds>(benchmarkConfig.runDuration).count();
+	std::vector<size_t> positions(traces.size(), 0u);  // of first trace point after current sample time
+	for (auto timeMs = samplingIntervalMs; timeMs <= durationMs; timeMs += samplingIntervalMs)
+	{
+		const double seconds = timeMs / 1000.0;
+		uint32_t runsWithSolution = 0u;
+		double sum = 0.0;
+		double min = std::numeric_limits<double>::infinity();
+		double max = -std::numeric_limits<double>::infinity();
+		for (auto run = 0u; run < traces.size(); run++)
+		{
+			auto& position = positions[run];
+			while (position < traces[run].size() && traces[run][position].seconds <= seconds)
+				position++;
+			if (position == 0)
+				continue;
+			const double fitness = traces[run][position - 1].fitness;
+			runsWithSolution++;
+			sum += fitness;
+			min = std::min(min, fitness);
+			max = std::max(max, fitness);
+		}
+		if (runsWithSolution == 0)
+			continue;
+		anytimeLogger.log("%s, %s, %lld, %d, %.4f, %.4f, %.4f", instanceName.c_str(), algorithmName.c_str(),
+			static_cast<long long>(timeMs), runsWithSolution, sum / runsWithSolution, min, max);
+	}
+}
+
+void AnytimeBenchmark::logTimesToTarget(const std::string& instanceName, const std::string& algorithmName,
+	const std::vector<Trace>& traces, const double referenceFitness)
+{
+	// -1 marks target not reached within run duration
+	for (const auto gap : benchmarkConfig.targetGaps)
+	{
+		const double targetFitness = referenceFitness - gap * std::abs(referenceFitness);
+		uint32_t reachedNum = 0u;
+		for (auto run = 0u; run < traces.size(); run++)
+		{
+			const auto reached = std::find_if(traces[run].cbegin(), traces[run].cend(),
+				[targetFitness](const auto& point) {return point.fitness >= targetFitness; });
+			const double timeMs = reached != traces[run].cend() ? reached->seconds * 1000.0 : -1.0;
+			reachedNum += reached != traces[run].cend() ? 1u : 0u;
+			timeToTargetLogger.log("%s, %s, %.4f, %.4f, %d, %.3f", instanceName.c_str(), algorithmName.c_str(),
+				gap, targetFitness, run + 1, timeMs);
+		}
+		std::cout << instanceName << ", " << algorithmName << ": target gap " << gap << " reached in " << reachedNum
+			<< " of " << traces.size() << " runs" << std::endl;
+	}
+}
+
+} // namespace benchmark
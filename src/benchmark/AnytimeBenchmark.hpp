@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <configuration/BenchmarkConfig.hpp>
+#include <configuration/GAlgConfig.hpp>
+#include <configuration/TtpConfig.hpp>
+#include <logger/Logger.hpp>
+
+namespace benchmark {
+
+// Quality per second comparison: GA and greedy / random baselines get the same time budget on every instance, every
+// improvement of best fitness is timestamped. Writes mean anytime curves sampled every samplingInterval and times to
+// targets placed below best fitness seen on the instance. Runs are sequential, so their timings don't disturb each other.
+class AnytimeBenchmark
+{
+public:
+	AnytimeBenchmark(const config::BenchmarkConfig& benchmarkConfig, const config::GAlgConfig& gAlgConfig,
+		const std::vector<config::TtpConfig>& instances);
+
+	AnytimeBenchmark() = delete;
+	AnytimeBenchmark(const AnytimeBenchmark&) = delete;
+	AnytimeBenchmark(AnytimeBenchmark&&) = delete;
+	~AnytimeBenchmark() = default;
+
+	AnytimeBenchmark& operator=(const AnytimeBenchmark&) = delete;
+	AnytimeBenchmark& operator=(AnytimeBenchmark&&) = delete;
+
+	void run();
+
+private:
+	struct TracePoint
+	{
+		double seconds;  // since run start
+		double fitness;  // best so far
+	};
+	using Trace = std::vector<TracePoint>;
+
+	Trace runGAlg(const config::TtpConfig& ttpConfig) const;
+	Trace runNaiveAlg(const config::TtpConfig& ttpConfig, const bool isGreedy) const;
+	void logAnytimeCurve(const std::string& instanceName, const std::string& algorithmName, const std::vector<Trace>& traces);
+	void logTimesToTarget(const std::string& instanceName, const std::string& algorithmName, const std::vector<Trace>& traces,
+		const double referenceFitness);
+
+	const config::BenchmarkConfig benchmarkConfig;
+	const config::GAlgConfig gAlgConfig;
+	const std::vector<config::TtpConfig>& instances;
+	logging::Logger anytimeLogger;
+	logging::Logger timeToTargetLogger;
+};
+
+} // namespace benchmark
@@ -0,0 +1,116 @@
+#include "TourStructureBenchmark.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <ttp/City.hpp>
+#include <ttp/TwoLevelTour.hpp>
+#include <utils/RandomUtils.hpp>
+
+namespace benchmark {
+
+namespace {
+
+using SteadyClock = std::chrono::steady_clock;
+
+struct Move
+{
+	uint32_t first;  // positions in city chain
+	uint32_t last;
+};
+
+double getNsPerOperation(const SteadyClock::time_point start, const uint32_t operationsNum)
+{
+	return std::chrono::duration<double, std::nano>(SteadyClock::now() - start).count() / operationsNum;
+}
+
+} // namespace
+
+std::string TourStructureTimings::getStringRepresentation() const
+{
+	char buffer[200];
+	std::snprintf(buffer, sizeof(buffer), "%u, %.1f, %.1f, %.2f, %.2f",
+		citiesNum, arrayReversalNs, twoLevelReversalNs, arrayQueryNs, twoLevelQueryNs);
+	return buffer;
+}
+
+TourStructureBenchmark::TourStructureBenchmark(const uint32_t movesNum)
+	: movesNum(movesNum)
+{
+}
+
+TourStructureTimings TourStructureBenchmark::measure(const uint32_t citiesNum) const
+{
+	utils::rnd::RandomEngine gen(utils::rnd::Random::getGlobalSeed(), citiesNum);
+	auto drawIndex = [&gen, citiesNum]() {return static_cast<uint32_t>(((gen() >> 32) * citiesNum) >> 32); };
+	std::vector<ttp::City> cityChain(citiesNum);
+	for (auto i = 0u; i < citiesNum; i++)
+		cityChain[i] = { i + 1, static_cast<double>(i), 0.0 };
+	std::shuffle(cityChain.begin(), cityChain.end(), gen);
+	std::vector<Move> moves(movesNum);
+	for (auto& move : moves)
+	{
+		// head stays in place, as two-level tour requires
+		move = { drawIndex(), drawIndex() };
+		if (move.first > move.last)
+			std::swap(move.first, move.last);
+		move.first = std::max(move.first, 1u);
+		move.last = std::max(move.last, move.first);
+	}
+
+	TourStructureTimings timings{ citiesNum, 0.0, 0.0, 0.0, 0.0 };
+	ttp::TwoLevelTour twoLevelTour(cityChain);
+	std::vector<uint32_t> positions(citiesNum + 1);
+	for (auto i = 0u; i < citiesNum; i++)
+		positions[cityChain[i].index] = i;
+	auto start = SteadyClock::now();
+	for (const auto& move : moves)
+	{
+		std::reverse(cityChain.begin() + move.first, cityChain.begin() + move.last + 1);
+		for (auto i = move.first; i <= move.last; i++)
+			positions[cityChain[i].index] = i;
+	}
+	timings.arrayReversalNs = getNsPerOperation(start, movesNum);
+
+	// moves are translated to end cities up front, two-level tour is timed on them only
+	auto shadowChain = twoLevelTour.getCityIds();
+	std::vector<std::pair<uint32_t, uint32_t>> moveEnds(movesNum);
+	for (auto m = 0u; m < movesNum; m++)
+	{
+		moveEnds[m] = { shadowChain[moves[m].first], shadowChain[moves[m].last] };
+		std::reverse(shadowChain.begin() + moves[m].first, shadowChain.begin() + moves[m].last + 1);
+	}
+	start = SteadyClock::now();
+	for (const auto& moveEnd : moveEnds)
+		twoLevelTour.reversePath(moveEnd.first, moveEnd.second);
+	timings.twoLevelReversalNs = getNsPerOperation(start, movesNum);
+
+	uint64_t checksum = 0u;
+	start = SteadyClock::now();
+	for (const auto& moveEnd : moveEnds)
+	{
+		const auto next = cityChain[positions[moveEnd.first] + 1 == citiesNum ? 0 : positions[moveEnd.first] + 1].index;
+		const auto from = positions[moveEnd.first];
+		const auto to = positions[moveEnd.second];
+		const auto pos = positions[next];
+		checksum += next + (from <= to ? from <= pos && pos <= to : pos >= from || pos <= to);
+	}
+	timings.arrayQueryNs = getNsPerOperation(start, movesNum);
+	start = SteadyClock::now();
+	for (const auto& moveEnd : moveEnds)
+	{
+		const auto next = twoLevelTour.getNext(moveEnd.first);
+		checksum -= next + twoLevelTour.isBetween(moveEnd.first, next, moveEnd.second);
+	}
+	timings.twoLevelQueryNs = getNsPerOperation(start, movesNum);
+
+	if (checksum != 0u || twoLevelTour.getCityIds() != shadowChain)
+		throw std::runtime_error("Tour structures diverged in benchmark");
+	return timings;
+}
+
+} // namespace benchmark
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace benchmark {
+
+struct TourStructureTimings
+{
+	std::string getStringRepresentation() const;
+
+	uint32_t citiesNum;
+	double arrayReversalNs;  // per move
+	double twoLevelReversalNs;
+	double arrayQueryNs;  // next and between, per query
+	double twoLevelQueryNs;
+};
+
+// 2-opt moves on random tours with uniformly drawn ends, as done by mutation and local search: city chain array
+// reversed in place with positions of moved cities updated, against TwoLevelTour. Both get the same moves.
+class TourStructureBenchmark
+{
+public:
+	explicit TourStructureBenchmark(const uint32_t movesNum);
+
+	TourStructureTimings measure(const uint32_t citiesNum) const;
+
+private:
+	const uint32_t movesNum;
+};
+
+} // namespace benchmark
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace config {
+
+// Anytime benchmark: GA and naive baselines on every instance for runsNum random streams, same time budget for all
+struct BenchmarkConfig
+{
+	std::vector<std::string> instanceFilePaths;
+	uint32_t runsNum = 10u;  // per instance and algorithm, run k uses random stream k + 1
+	std::chrono::seconds runDuration = std::chrono::seconds(10);
+	std::chrono::milliseconds samplingInterval = std::chrono::milliseconds(10);  // resolution of mean anytime curves
+	std::vector<double> targetGaps{ 0.0, 0.01, 0.05, 0.1 };  // targets below best fitness seen on instance, relative to its magnitude
+	std::string resultsCsvPrefix;  // <prefix>anytime.csv, <prefix>ttt.csv
+};
+
+} // namespace config
@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <chrono>
 #include <string>
+#include <vector>
 
 namespace config {
 
@@ -15,17 +16,66 @@ struct GAlgParams
 	std::chrono::seconds maxGAlgDuration;  // 0s indicates no time limit
 	double crossoverProb;
 	double mutationProb;
+	std::string crossoverType = "nrx";  // one of: nrx, pmx, ox, cx, erx
+	bool diversityMonitor = false;
+	uint32_t diversitySamplePairs = 100u;  // pairs of tours sampled for edge distance estimation
+	double diversityInjectionThreshold = 0.0;  // distinct tours ratio below which duplicates are replaced, 0 disables
+	uint32_t elitismSize = 0u;  // best individuals carried over to next population
+	bool eliminateDuplicates = false;
+	double surrogateOversampling = 1.0;  // offsprings bred per evaluated one, the rest is dropped by surrogate estimate; 1 disables
+	uint32_t threadsNum = 0u;  // used by multithreaded engines, 0 indicates all hardware threads
+	bool adaptiveOperators = false;  // bandits pick crossover type and crossover / mutation probability levels for every breeding
+	std::vector<std::string> adaptiveCrossoverTypes{ "nrx", "pmx", "ox", "cx", "erx" };  // arms of crossover type bandit
+	uint32_t exactPackingElites = 0u;  // copies of best individuals of every population repacked optimally, for best so far only; 0 disables
+	uint64_t exactPackingMaxStates = 200000000u;  // items * (capacity + 1) above which exact packing turns itself off
+};
+
+// parallel tempering, stop conditions and threads num are taken from GAlgParams
+struct SaParams
+{
+	uint32_t chainsNum = 8u;  // one fixed temperature per chain
+	uint32_t movesPerExchange = 1000u;  // moves done by every chain between exchanges of states
+	double maxTemperature = 0.0;  // 0 indicates calibration on sampled worsening moves
+	double minTemperature = 0.0;  // 0 indicates maxTemperature / 1000
+};
+
+// MAX-MIN ant system, ants num, stop conditions and threads num are taken from GAlgParams
+struct AcoParams
+{
+	uint32_t candidatesNum = 15u;  // nearest neighbours per city carrying pheromone
+	double alpha = 1.0;  // pheromone exponent
+	double beta = 2.0;  // inverse distance exponent
+	double evaporationRate = 0.02;
+};
+
+// decomposition of large instances, GA parameters of cluster runs, their stop conditions and threads num are taken from GAlgParams
+struct DecompositionParams
+{
+	uint32_t clusterSize = 500u;  // upper bound of cities per cluster, clusters are consecutive cities along Hilbert curve
 };
 
 struct GAlgConfig
 {
 	GAlgParams gAlgParams;
+	SaParams saParams;
+	AcoParams acoParams;
+	DecompositionParams decompositionParams;
+	std::string algorithm = "ga";  // one of: ga, async_ga, pt_sa, mmas, decomposition
 	std::string instanceFilePath;
 	std::string resultsCsvFile;
 	std::string bestIndividualResultFile;
 	std::string bestGreedyAlgPath;
 	std::string bestRandomAlgPath;
-	uint32_t naiveRepetitions;
+	uint32_t naiveRepetitions;  // 0 skips greedy and random baselines
+	uint64_t randomSeed = 0u;  // 0 indicates nondeterministic seed
+	bool pruneUnprofitableItems = false;
+	bool pruneDominatedItems = false;
+	bool renumberCities = false;  // along Hilbert curve, for memory locality
+	std::string evaluationPrecision = "double";  // one of: double, float
+	std::string threadPinning = "none";  // one of: none, compact, scatter
+	int32_t numaNode = -1;  // process is bound to cpus of this NUMA node, -1 disables, -2 picks node by run number
+	bool hugePages = false;  // transparent huge pages advised for big instance tables
+	uint64_t memoryBudgetMb = 0u;  // population size is capped so peak footprint of a run fits, 0 disables
 };
 
 } // namespace config
@@ -2,39 +2,83 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <limits>
 #include <unordered_map>
 #include <string>
 #include <vector>
 
 #include <ttp/City.hpp>
 #include <ttp/Item.hpp>
+#include <utils/GeometryUtils.hpp>
 
 namespace config {
 
+// Tour independent item data used by packing heuristic
+struct RankedItem
+{
+	ttp::Item item;
+	double inverseVelocity;  // 1 / velocity when carrying only this item
+	double breakEvenDistance;  // carrying item further than that costs more time than its profit
+};
+
+enum class EvaluationPrecision
+{
+	doublePrecision,
+	singlePrecision  // float geometry and trip time sums, fitness is approximate
+};
+
 struct TtpConfig
 {
 	void fillNearestDistanceLookup()
 	{
-		auto minDistance = std::numeric_limits<double>::infinity();
+		const auto nearestCities = utils::geo::findNearestCities(cities);
+		nearestDistanceLookup.clear();
+		nearestDistanceLookup.reserve(cities.size());
 		for (auto i = 0u; i < cities.size(); i++)
+			nearestDistanceLookup[i + 1] = nearestCities[i];  // + 1 cause of cities numeration in config
+	}
+
+	void fillRankedItemsPerCity()
+	{
+		const auto citiesNum = static_cast<uint32_t>(cities.size());
+		itemsPerCityOffsets.assign(citiesNum + 2, 0u);
+		for (const auto& item : items)
+			itemsPerCityOffsets[item.cityId + 1]++;
+		for (auto cityId = 1u; cityId <= citiesNum + 1; cityId++)
+			itemsPerCityOffsets[cityId] += itemsPerCityOffsets[cityId - 1];
+
+		const double velocityDrop = (maxVelocity - minVelocity) / capacityOfKnapsack;
+		auto insertPositions = itemsPerCityOffsets;
+		rankedItemsPerCity.resize(items.size());
+		for (const auto& item : items)
+		{
+			double velocity = item.weight >= capacityOfKnapsack ? minVelocity : maxVelocity - item.weight * velocityDrop;
+			double timePenaltyPerDistance = 1.0 / velocity - 1.0 / maxVelocity;
+			double breakEvenDistance =
+				timePenaltyPerDistance > 0 ? item.profit / timePenaltyPerDistance : std::numeric_limits<double>::infinity();
+			rankedItemsPerCity[insertPositions[item.cityId]++] = RankedItem{ item, 1.0 / velocity, breakEvenDistance };
+		}
+		for (auto cityId = 1u; cityId <= citiesNum; cityId++)
 		{
-			auto nearestIndex = 0u;
-			for (auto j = 0u; j < cities.size(); j++)
-			{
-				if (j == i)
-					continue;
-				auto distance = cities[i].getDistance(cities[j]);
-				if (distance < minDistance)
-				{
-					minDistance = distance;
-					nearestIndex = j;
-				}
-			}
-			nearestDistanceLookup[i + 1] = std::make_pair(nearestIndex + 1, minDistance);  // + 1 cause of cities numeration in config
-			minDistance = std::numeric_limits<double>::infinity();
+			std::sort(rankedItemsPerCity.begin() + itemsPerCityOffsets[cityId], rankedItemsPerCity.begin() + itemsPerCityOffsets[cityId + 1],
+				[](const auto& lhs, const auto& rhs) {return lhs.breakEvenDistance > rhs.breakEvenDistance; });
 		}
 	}
 
+	uint32_t getOriginalCityId(const uint32_t cityId) const
+	{
+		return originalCityIds.empty() ? cityId : originalCityIds[cityId];
+	}
+
+	uint64_t getMemoryFootprint() const  // approximate, hash map nodes counted with one pointer of overhead
+	{
+		using LookupNode = std::pair<const uint32_t, std::pair<uint32_t, double>>;
+		return sizeof(TtpConfig) + cities.capacity() * sizeof(ttp::City) + items.capacity() * sizeof(ttp::Item) +
+			nearestDistanceLookup.bucket_count() * sizeof(void*) + nearestDistanceLookup.size() * (sizeof(LookupNode) + sizeof(void*)) +
+			itemsPerCityOffsets.capacity() * sizeof(uint32_t) + rankedItemsPerCity.capacity() * sizeof(RankedItem) +
+			originalCityIds.capacity() * sizeof(uint32_t);
+	}
+
 	std::string problemName;
 	std::string knapsackDataType;
 	uint32_t dimenssion;
@@ -46,5 +90,11 @@ struct TtpConfig
 	std::vector<ttp::City> cities;
 	std::vector<ttp::Item> items;
 	std::unordered_map<uint32_t, std::pair<uint32_t, double>> nearestDistanceLookup;
+	// items of city with given id are rankedItemsPerCity[itemsPerCityOffsets[id]] .. rankedItemsPerCity[itemsPerCityOffsets[id + 1] - 1],
+	// sorted by break even distance, descending
+	std::vector<uint32_t> itemsPerCityOffsets;
+	std::vector<RankedItem> rankedItemsPerCity;
+	std::vector<uint32_t> originalCityIds;  // indexed by city id, empty when ids are kept as in instance file
+	EvaluationPrecision evaluationPrecision = EvaluationPrecision::doublePrecision;  // run setting, not read from instance file
 };
 } // namespace config
\ No newline at end of file
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <chrono>
+#include <string>
+#include <vector>
+
+namespace config {
+
+// Parameter race over GAlgParams: candidates are all combinations of listed values, an empty list keeps value from gaConfig.txt
+struct TuningConfig
+{
+	std::vector<std::string> instanceFilePaths;  // used round robin, one instance per round
+	std::vector<uint32_t> populationSizes;
+	std::vector<uint32_t> tournamentSizes;
+	std::vector<double> crossoverProbs;
+	std::vector<double> mutationProbs;
+	std::vector<std::string> crossoverTypes;
+	uint32_t runMaxPopulationsNum = 100u;  // budget of every single run, 0 indicates no populations num limit
+	std::chrono::seconds runMaxGAlgDuration = std::chrono::seconds::zero();  // 0s indicates no time limit
+	uint32_t maxRounds = 50u;
+	uint32_t firstEliminationRound = 5u;  // rounds run by all candidates before first statistical test
+	double significanceLevel = 0.05;
+	uint32_t threadsNum = 0u;  // parallel runs, 0 indicates all hardware threads
+	std::string resultsCsvFile;  // ranked table
+};
+
+} // namespace config
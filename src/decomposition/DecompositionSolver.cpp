@@ -0,0 +1,209 @@
+#include "DecompositionSolver.hpp"
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+#include <ga/GAlg.hpp>
+#include <utils/Affinity.hpp>
+#include <utils/GeometryUtils.hpp>
+#include <utils/RandomUtils.hpp>
+#include <utils/ThreadPool.hpp>
+
+namespace decomposition {
+
+DecompositionSolver::DecompositionSolver(const config::GAlgParams& params, const config::DecompositionParams& decompositionParams,
+	const config::TtpConfig& ttpConfig, logging::Logger& logger)
+	: params(params)
+	, decompositionParams(decompositionParams)
+	, ttpConfig(ttpConfig)
+	, threadsNum(params.threadsNum != 0 ? params.threadsNum : std::max(1u, std::thread::hardware_concurrency()))
+	, totalItemsWeight(0u)
+	, logger(logger)
+{
+	if (decompositionParams.clusterSize < 3)
+		throw std::runtime_error("Decomposition cluster size can't be lower than 3");
+}
+
+void DecompositionSolver::run()
+{
+	formClusters();
+	solveClusters();
+	packGlobalTour(stitchClusterTours());
+}
+
+DecompositionSolver::IndividualPtr DecompositionSolver::getBestIndividual() const
+{
+	return std::make_unique<ttp::TtpIndividual>(*bestIndividual);
+}
+
+void DecompositionSolver::formClusters()
+{
+	// sizes differ by at most one city, so no cluster is left too small to be solved by GA
+	clusterCities = utils::geo::orderAlongHilbertCurve(ttpConfig.cities);
+	const auto citiesNum = static_cast<uint32_t>(clusterCities.size());
+	const auto clustersNum = std::max(1u, (citiesNum + decompositionParams.clusterSize - 1) / decompositionParams.clusterSize);
+	clusterOffsets.resize(clustersNum + 1);
+	for (auto clusterId = 0u; clusterId <= clustersNum; clusterId++)
+		clusterOffsets[clusterId] = static_cast<uint32_t>(static_cast<uint64_t>(citiesNum) * clusterId / clustersNum);
+	localIdOf.assign(citiesNum + 1, 0u);
+	for (auto clusterId = 0u; clusterId < clustersNum; clusterId++)
+	{
+		for (auto pos = clusterOffsets[clusterId]; pos < clusterOffsets[clusterId + 1]; pos++)
+			localIdOf[clusterCities[pos]] = pos - clusterOffsets[clusterId] + 1;
+	}
+	totalItemsWeight = 0u;
+	for (const auto& item : ttpConfig.items)
+		totalItemsWeight += item.weight;
+	clusterTours.assign(clustersNum, {});
+	clusterFitnesses.assign(clustersNum, 0.0);
+}
+
+void DecompositionSolver::solveClusters()
+{
+	const auto clustersNum = static_cast<uint32_t>(clusterTours.size());
+	auto solveStrided = [this, clustersNum](const uint32_t firstCluster, const uint32_t step) {
+		utils::affinity::pinCurrentThread(firstCluster);  // cluster configs and populations are allocated by the worker
+		for (auto clusterId = firstCluster; clusterId < clustersNum; clusterId += step)
+			solveCluster(clusterId);
+	};
+	utils::runWorkers(std::min(threadsNum, clustersNum), solveStrided);
+	for (auto clusterId = 0u; clusterId < clustersNum; clusterId++)
+	{
+		logger.log("%u, %u, %.4f", clusterId, clusterOffsets[clusterId + 1] - clusterOffsets[clusterId],
+			clusterFitnesses[clusterId]);
+	}
+}
+
+void DecompositionSolver::solveCluster(const uint32_t clusterId)
+{
+	utils::rnd::Random::getInstance().useStream(clusterId + 1);  // stream 0 is used by calling thread
+	const auto clusterConfig = makeClusterConfig(clusterId);
+	auto createRandomFun = [&clusterConfig]() {
+		return ttp::TtpIndividual::createRandom(clusterConfig, utils::rnd::Random::getInstance().getRndGen()); };
+	logging::Logger clusterLogger("");
+	ga::GAlg<ttp::TtpIndividual> gAlg(params, createRandomFun, clusterLogger);
+	gAlg.run();
+	const auto best = gAlg.getBestIndividual();
+	const auto firstPos = clusterOffsets[clusterId];
+	auto& clusterTour = clusterTours[clusterId];
+	clusterTour.reserve(clusterConfig.cities.size());
+	for (const auto& city : best->getCityChain())
+		clusterTour.push_back(clusterCities[firstPos + city.index - 1]);
+	clusterFitnesses[clusterId] = best->getCurrentFitness();
+}
+
+config::TtpConfig DecompositionSolver::makeClusterConfig(const uint32_t clusterId) const
+{
+	config::TtpConfig clusterConfig;
+	clusterConfig.problemName = ttpConfig.problemName + "-cluster-" + std::to_string(clusterId);
+	clusterConfig.knapsackDataType = ttpConfig.knapsackDataType;
+	clusterConfig.minVelocity = ttpConfig.minVelocity;
+	clusterConfig.maxVelocity = ttpConfig.maxVelocity;
+	clusterConfig.rentingRatio = ttpConfig.rentingRatio;
+	clusterConfig.evaluationPrecision = ttpConfig.evaluationPrecision;
+	uint64_t clusterItemsWeight = 0u;
+	for (auto pos = clusterOffsets[clusterId]; pos < clusterOffsets[clusterId + 1]; pos++)
+	{
+		const auto cityId = clusterCities[pos];
+		const auto localId = localIdOf[cityId];
+		const auto& city = ttpConfig.cities[cityId - 1];
+		clusterConfig.cities.push_back({ localId, city.x, city.y });
+		for (auto k = ttpConfig.itemsPerCityOffsets[cityId]; k < ttpConfig.itemsPerCityOffsets[cityId + 1]; k++)
+		{
+			const auto& item = ttpConfig.rankedItemsPerCity[k].item;
+			clusterConfig.items.push_back({ static_cast<uint32_t>(clusterConfig.items.size() + 1), item.profit, item.weight, localId });
+			clusterItemsWeight += item.weight;
+		}
+	}
+	clusterConfig.dimenssion = static_cast<uint32_t>(clusterConfig.cities.size());
+	clusterConfig.itemsNum = static_cast<uint32_t>(clusterConfig.items.size());
+	const auto capacityShare = totalItemsWeight != 0 ? ttpConfig.capacityOfKnapsack * clusterItemsWeight / totalItemsWeight : 0u;
+	clusterConfig.capacityOfKnapsack = std::max(1u, static_cast<uint32_t>(capacityShare));
+	clusterConfig.fillNearestDistanceLookup();
+	clusterConfig.fillRankedItemsPerCity();
+	return clusterConfig;
+}
+
+std::vector<ttp::City> DecompositionSolver::stitchClusterTours() const
+{
+	// every cluster is opened towards centroid of the next one, the last one towards start of the tour
+	const auto clustersNum = static_cast<uint32_t>(clusterTours.size());
+	std::vector<ttp::City> tour;
+	tour.reserve(ttpConfig.cities.size());
+	for (auto clusterId = 0u; clusterId < clustersNum; clusterId++)
+	{
+		ttp::City target{ 0u, 0.0, 0.0 };
+		if (clusterId + 1 < clustersNum)
+		{
+			const auto& nextTour = clusterTours[clusterId + 1];
+			for (const auto cityId : nextTour)
+			{
+				target.x += ttpConfig.cities[cityId - 1].x / nextTour.size();
+				target.y += ttpConfig.cities[cityId - 1].y / nextTour.size();
+			}
+		}
+		else if (clusterId != 0)
+			target = tour.front();
+		appendOpenedTour(clusterTours[clusterId], tour.empty() ? nullptr : &tour.back(), target, tour);
+	}
+	return tour;
+}
+
+void DecompositionSolver::appendOpenedTour(const std::vector<uint32_t>& clusterTour, const ttp::City* previous,
+	const ttp::City& target, std::vector<ttp::City>& tour) const
+{
+	// removing edge (k, k + 1) opens the cycle into path k + 1 .. k going forward, or k .. k + 1 going backward
+	const auto citiesNum = static_cast<uint32_t>(clusterTour.size());
+	auto getCity = [this, &clusterTour](const uint32_t pos) -> const ttp::City& {return ttpConfig.cities[clusterTour[pos] - 1]; };
+	auto linkCost = [previous, &target](const ttp::City& first, const ttp::City& last) {
+		return (previous != nullptr ? previous->getDistance(first) : 0.0) + last.getDistance(target); };
+	auto bestCost = std::numeric_limits<double>::infinity();
+	auto bestPos = 0u;
+	bool isBestForward = true;
+	for (auto k = 0u; k < citiesNum; k++)
+	{
+		const auto& city = getCity(k);
+		const auto& nextCity = getCity(k + 1 == citiesNum ? 0 : k + 1);
+		const auto removedEdge = city.getDistance(nextCity);
+		const auto forwardCost = linkCost(nextCity, city) - removedEdge;
+		const auto backwardCost = linkCost(city, nextCity) - removedEdge;
+		if (forwardCost < bestCost)
+		{
+			bestCost = forwardCost;
+			bestPos = k;
+			isBestForward = true;
+		}
+		if (backwardCost < bestCost)
+		{
+			bestCost = backwardCost;
+			bestPos = k;
+			isBestForward = false;
+		}
+	}
+	for (auto i = 0u; i < citiesNum; i++)
+	{
+		const auto pos = isBestForward ? (bestPos + 1 + i) % citiesNum : (bestPos + citiesNum - i) % citiesNum;
+		tour.push_back(getCity(pos));
+	}
+}
+
+void DecompositionSolver::packGlobalTour(std::vector<ttp::City>&& tour)
+{
+	// packing depends on direction a lot, as items picked early are carried for the rest of the tour
+	auto reversedTour = tour;
+	std::reverse(reversedTour.begin(), reversedTour.end());
+	auto forward = std::make_unique<ttp::TtpIndividual>(ttpConfig, ttp::TspSolution(ttpConfig, std::move(tour)));
+	auto backward = std::make_unique<ttp::TtpIndividual>(ttpConfig, ttp::TspSolution(ttpConfig, std::move(reversedTour)));
+	forward->evaluate();
+	backward->evaluate();
+	bestIndividual = std::move(forward->getCurrentFitness() >= backward->getCurrentFitness() ? forward : backward);
+	if (params.exactPackingElites != 0)
+		bestIndividual->packExactly(params.exactPackingMaxStates);
+	std::cout << "decomposition: " << clusterTours.size() << " clusters, stitched tour fitness: "
+		<< bestIndividual->getCurrentFitness() << std::endl;
+}
+
+} // namespace decomposition
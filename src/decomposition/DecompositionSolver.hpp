@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <configuration/GAlgConfig.hpp>
+#include <configuration/TtpConfig.hpp>
+#include <logger/Logger.hpp>
+#include <ttp/TtpIndividual.hpp>
+
+namespace decomposition {
+
+// Solver for instances too big for whole-tour GA: cities are cut into clusters of consecutive cities along Hilbert curve,
+// every cluster with its items becomes separate TTP instance with capacity proportional to weight of its items, solved
+// by GAlg; clusters are solved in parallel. Cluster tours are opened at edges which give the cheapest link to previous
+// cluster and towards next one, then chained in curve order. The global tour is packed in both directions, better one
+// is kept. Only cluster configs of clusters being solved exist at a time, so memory stays linear in instance size.
+// Every cluster has its own random stream, so results don't depend on threads num. GA stop conditions apply per cluster.
+class DecompositionSolver
+{
+public:
+	using IndividualPtr = std::unique_ptr<ttp::TtpIndividual>;
+
+	DecompositionSolver(const config::GAlgParams& params, const config::DecompositionParams& decompositionParams,
+		const config::TtpConfig& ttpConfig, logging::Logger& logger);
+
+	DecompositionSolver() = delete;
+	DecompositionSolver(const DecompositionSolver&) = delete;
+	DecompositionSolver(DecompositionSolver&&) = delete;
+	~DecompositionSolver() = default;
+
+	DecompositionSolver& operator=(const DecompositionSolver&) = delete;
+	DecompositionSolver& operator=(DecompositionSolver&&) = delete;
+
+	void run();
+	IndividualPtr getBestIndividual() const;
+
+private:
+	void formClusters();
+	void solveClusters();
+	void solveCluster(const uint32_t clusterId);
+	config::TtpConfig makeClusterConfig(const uint32_t clusterId) const;
+	std::vector<ttp::City> stitchClusterTours() const;
+	void appendOpenedTour(const std::vector<uint32_t>& clusterTour, const ttp::City* previous, const ttp::City& target,
+		std::vector<ttp::City>& tour) const;
+	void packGlobalTour(std::vector<ttp::City>&& tour);
+
+	const config::GAlgParams params;
+	const config::DecompositionParams decompositionParams;
+	const config::TtpConfig& ttpConfig;
+	const uint32_t threadsNum;
+
+	std::vector<uint32_t> clusterOffsets;  // cities of cluster c are clusterCities[clusterOffsets[c]] .. [clusterOffsets[c + 1] - 1]
+	std::vector<uint32_t> clusterCities;  // global ids along Hilbert curve
+	std::vector<uint32_t> localIdOf;  // indexed by global city id, id within its cluster config
+	uint64_t totalItemsWeight;
+	std::vector<std::vector<uint32_t>> clusterTours;  // global ids, cycles found by GAlg
+	std::vector<double> clusterFitnesses;
+	IndividualPtr bestIndividual;
+	logging::Logger& logger;
+};
+
+} // namespace decomposition
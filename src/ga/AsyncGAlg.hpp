@@ -0,0 +1,272 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <utils/Affinity.hpp>
+#include <utils/RandomUtils.hpp>
+#include <utils/ThreadPool.hpp>
+#include <logger/Logger.hpp>
+#include <configuration/GAlgConfig.hpp>
+#include "CrossoverFun.hpp"
+
+namespace ga {
+
+// Steady-state GA without generation barriers: every worker repeatedly selects parents by tournament,
+// breeds and evaluates offspring, and replaces the worst of a random sample if offspring is better.
+// Population slots are guarded by per-slot locks, tournaments read lock-free fitness copies.
+// One "generation" in logs and stop conditions stands for populationSize evaluated offspring.
+template <class Individual>
+class AsyncGAlg
+{
+public:
+	using IndividualPtr = std::unique_ptr<Individual>;
+
+	AsyncGAlg(const config::GAlgParams& params, std::function<IndividualPtr(void)> createRandomFun, logging::Logger& logger);
+
+	AsyncGAlg() = delete;
+	AsyncGAlg(const AsyncGAlg&) = delete;
+	AsyncGAlg(AsyncGAlg&&) = delete;
+	~AsyncGAlg() = default;
+
+	AsyncGAlg& operator=(const AsyncGAlg&) = delete;
+	AsyncGAlg& operator=(AsyncGAlg&&) = delete;
+
+	void run();
+	IndividualPtr getBestIndividual() const;
+
+private:
+	using SharedIndividual = std::shared_ptr<const Individual>;
+	using SteadyClock = std::chrono::steady_clock;
+
+	void initialize(const uint32_t workerId);
+	void workerLoop(const uint32_t workerId);
+	void breed(const Individual& parent1, const Individual& parent2, std::vector<IndividualPtr>& offsprings);
+	uint32_t selectParentIndex(std::vector<uint32_t>& contestants) const;
+	uint32_t selectReplacedIndex(std::vector<uint32_t>& contestants) const;
+	SharedIndividual loadSlot(const uint32_t index) const;
+	void insert(IndividualPtr offspring, std::vector<uint32_t>& contestants);
+	void storeSlot(const uint32_t index, SharedIndividual individual);
+	void updateBestIndividual(const SharedIndividual& candidate);
+	bool checkStopConditions() const;
+	void logState(const uint32_t populationsNum) const;
+
+	const config::GAlgParams params;
+	std::function<IndividualPtr(void)> createRandomFun;
+	CrossoverFun<Individual> crossoverFun;
+	const uint32_t threadsNum;
+
+	std::vector<SharedIndividual> population;
+	std::unique_ptr<std::atomic<double>[]> fitnesses;
+	mutable std::vector<std::mutex> slotsMutexes;
+
+	SharedIndividual bestIndividualSoFar;
+	mutable std::mutex bestIndividualMutex;
+	logging::Logger& logger;
+	mutable std::mutex loggerMutex;
+	std::atomic<uint64_t> evaluationsNum;
+	std::atomic<bool> stopRequested;
+	SteadyClock::time_point startTimestamp;
+};
+
+template<class Individual>
+AsyncGAlg<Individual>::AsyncGAlg(const config::GAlgParams& params, std::function<IndividualPtr(void)> createRandomFun, logging::Logger& logger)
+	: params(params)
+	, createRandomFun(std::move(createRandomFun))
+	, crossoverFun(makeCrossoverFun<Individual>(params.crossoverType))
+	, threadsNum(params.threadsNum != 0 ? params.threadsNum : std::max(1u, std::thread::hardware_concurrency()))
+	, population(params.populationSize)
+	, fitnesses(std::make_unique<std::atomic<double>[]>(params.populationSize))
+	, slotsMutexes(params.populationSize)
+	, logger(logger)
+	, evaluationsNum(0u)
+	, stopRequested(false)
+{
+	if (params.populationSize < 2)
+		throw std::runtime_error("Population size for async GA has to be at least 2");
+	if (params.tournamentSize == 0)
+		throw std::runtime_error("Tournament size can't be 0");
+}
+
+template<class Individual>
+void AsyncGAlg<Individual>::run()
+{
+	startTimestamp = SteadyClock::now();
+	auto runWorkers = [this](auto workerFun) {
+		utils::runWorkers(threadsNum, [&workerFun](const uint32_t workerId, const uint32_t) {
+			utils::affinity::pinCurrentThread(workerId);  // slots a worker initializes are first touched on its node
+			workerFun(workerId);
+		});
+	};
+	runWorkers([this](const uint32_t workerId) {initialize(workerId); });
+	logState(0u);
+	runWorkers([this](const uint32_t workerId) {workerLoop(workerId); });
+}
+
+template<class Individual>
+typename AsyncGAlg<Individual>::IndividualPtr AsyncGAlg<Individual>::getBestIndividual() const
+{
+	std::lock_guard<std::mutex> lock(bestIndividualMutex);
+	return std::make_unique<Individual>(*bestIndividualSoFar);
+}
+
+template<class Individual>
+void AsyncGAlg<Individual>::initialize(const uint32_t workerId)
+{
+	utils::rnd::Random::getInstance().useStream(workerId);
+	for (auto index = workerId; index < params.populationSize; index += threadsNum)
+	{
+		auto individual = createRandomFun();
+		individual->evaluate();
+		SharedIndividual shared = std::move(individual);
+		updateBestIndividual(shared);
+		storeSlot(index, std::move(shared));
+	}
+}
+
+template<class Individual>
+void AsyncGAlg<Individual>::workerLoop(const uint32_t workerId)
+{
+	utils::rnd::Random::getInstance().useStream(threadsNum + workerId);
+	std::vector<uint32_t> contestants(params.tournamentSize);
+	std::vector<IndividualPtr> offsprings;
+	while (!stopRequested)
+	{
+		if (checkStopConditions())
+		{
+			stopRequested = true;
+			break;
+		}
+		auto parent1 = loadSlot(selectParentIndex(contestants));
+		auto parent2 = loadSlot(selectParentIndex(contestants));
+		offsprings.clear();
+		breed(*parent1, *parent2, offsprings);
+		for (auto& offspring : offsprings)
+		{
+			offspring->evaluate();
+			insert(std::move(offspring), contestants);
+			auto evaluated = ++evaluationsNum;
+			if (evaluated % params.populationSize == 0)
+				logState(static_cast<uint32_t>(evaluated / params.populationSize));
+		}
+	}
+}
+
+template<class Individual>
+void AsyncGAlg<Individual>::breed(const Individual& parent1, const Individual& parent2, std::vector<IndividualPtr>& offsprings)
+{
+	auto& random = utils::rnd::Random::getInstance();
+	if (random.getBernoulli(params.crossoverProb))
+	{
+		auto [offspring1, offspring2] = crossoverFun(parent1, parent2);
+		offsprings.push_back(std::move(offspring1));
+		if (offspring2 != nullptr)
+			offsprings.push_back(std::move(offspring2));
+	}
+	else
+	{
+		// unchanged clones bring nothing to steady-state population, so cloned parent is always mutated
+		offsprings.push_back(std::make_unique<Individual>(random.getBernoulli(0.5) ? parent1 : parent2));
+		offsprings.back()->mutation();
+		return;
+	}
+	for (auto& offspring : offsprings)
+	{
+		if (random.getBernoulli(params.mutationProb))
+			offspring->mutation();
+	}
+}
+
+template<class Individual>
+uint32_t AsyncGAlg<Individual>::selectParentIndex(std::vector<uint32_t>& contestants) const
+{
+	auto& random = utils::rnd::Random::getInstance();
+	random.fillRandomUints(contestants.data(), contestants.size(), 0, params.populationSize - 1);
+	return *std::max_element(contestants.cbegin(), contestants.cend(),
+		[this](const auto lhs, const auto rhs) {return fitnesses[lhs].load(std::memory_order_relaxed) < fitnesses[rhs].load(std::memory_order_relaxed); });
+}
+
+template<class Individual>
+uint32_t AsyncGAlg<Individual>::selectReplacedIndex(std::vector<uint32_t>& contestants) const
+{
+	auto& random = utils::rnd::Random::getInstance();
+	random.fillRandomUints(contestants.data(), contestants.size(), 0, params.populationSize - 1);
+	return *std::min_element(contestants.cbegin(), contestants.cend(),
+		[this](const auto lhs, const auto rhs) {return fitnesses[lhs].load(std::memory_order_relaxed) < fitnesses[rhs].load(std::memory_order_relaxed); });
+}
+
+template<class Individual>
+typename AsyncGAlg<Individual>::SharedIndividual AsyncGAlg<Individual>::loadSlot(const uint32_t index) const
+{
+	std::lock_guard<std::mutex> lock(slotsMutexes[index]);
+	return population[index];
+}
+
+template<class Individual>
+void AsyncGAlg<Individual>::insert(IndividualPtr offspring, std::vector<uint32_t>& contestants)
+{
+	auto replacedIndex = selectReplacedIndex(contestants);
+	SharedIndividual shared = std::move(offspring);
+	{
+		// slot could have been replaced since selection, so comparison is repeated under lock
+		std::lock_guard<std::mutex> lock(slotsMutexes[replacedIndex]);
+		if (shared->getCurrentFitness() <= population[replacedIndex]->getCurrentFitness())
+			return;
+		fitnesses[replacedIndex].store(shared->getCurrentFitness(), std::memory_order_relaxed);
+		population[replacedIndex] = shared;
+	}
+	updateBestIndividual(shared);
+}
+
+template<class Individual>
+void AsyncGAlg<Individual>::storeSlot(const uint32_t index, SharedIndividual individual)
+{
+	std::lock_guard<std::mutex> lock(slotsMutexes[index]);
+	fitnesses[index].store(individual->getCurrentFitness(), std::memory_order_relaxed);
+	population[index] = std::move(individual);
+}
+
+template<class Individual>
+void AsyncGAlg<Individual>::updateBestIndividual(const SharedIndividual& candidate)
+{
+	// individuals are immutable once published, so best one is kept by pointer, not copied
+	std::lock_guard<std::mutex> lock(bestIndividualMutex);
+	if (bestIndividualSoFar == nullptr || candidate->getCurrentFitness() > bestIndividualSoFar->getCurrentFitness())
+		bestIndividualSoFar = candidate;
+}
+
+template<class Individual>
+bool AsyncGAlg<Individual>::checkStopConditions() const
+{
+	if (params.maxPopulationsNum != 0 && evaluationsNum >= static_cast<uint64_t>(params.maxPopulationsNum) * params.populationSize)
+		return true;
+	return params.maxGAlgDuration != std::chrono::seconds::zero() && SteadyClock::now() - startTimestamp >= params.maxGAlgDuration;
+}
+
+template<class Individual>
+void AsyncGAlg<Individual>::logState(const uint32_t populationsNum) const
+{
+	// fitnesses are read while other workers keep inserting, so statistics are approximate
+	double best = -std::numeric_limits<double>::infinity();
+	double worst = std::numeric_limits<double>::infinity();
+	double sum = 0.0;
+	for (auto i = 0u; i < params.populationSize; i++)
+	{
+		auto fitness = fitnesses[i].load(std::memory_order_relaxed);
+		best = std::max(best, fitness);
+		worst = std::min(worst, fitness);
+		sum += fitness;
+	}
+	std::lock_guard<std::mutex> lock(loggerMutex);
+	logger.log("%d, %.4f, %.4f, %.4f", populationsNum, best, sum / params.populationSize, worst);
+}
+
+} // namespace ga
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace ga {
+
+template <class Individual>
+using OffspringsPtrsPair = std::pair<std::unique_ptr<Individual>, std::unique_ptr<Individual>>;
+
+template <class Individual>
+using CrossoverFun = std::function<OffspringsPtrsPair<Individual>(const Individual&, const Individual&)>;
+
+template <class Individual>
+CrossoverFun<Individual> makeCrossoverFun(const std::string& crossoverType)
+{
+	// single offspring operators leave second pointer empty
+	using Offsprings = OffspringsPtrsPair<Individual>;
+	if (crossoverType == "nrx")
+		return [](const Individual& parent1, const Individual& parent2) {
+			return Offsprings(parent1.crossoverNrx(parent2), nullptr); };
+	else if (crossoverType == "erx")
+		return [](const Individual& parent1, const Individual& parent2) {
+			return Offsprings(parent1.crossoverErx(parent2), nullptr); };
+	else if (crossoverType == "pmx")
+		return [](const Individual& parent1, const Individual& parent2) {return parent1.crossoverPmx(parent2); };
+	else if (crossoverType == "ox")
+		return [](const Individual& parent1, const Individual& parent2) {return parent1.crossoverOx(parent2); };
+	else if (crossoverType == "cx")
+		return [](const Individual& parent1, const Individual& parent2) {return parent1.crossoverCx(parent2); };
+	else
+		throw std::runtime_error("Provided crossover type: " + crossoverType + " not matching any available operator");
+}
+
+} // namespace ga
@@ -1,18 +1,28 @@
 #pragma once
 #include <iostream>
 #include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <cmath>
+#include <cstdio>
 #include <functional>
 #include <memory>
 #include <numeric>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include <utils/RandomUtils.hpp>
+#include <utils/StatisticsUtils.hpp>
 #include <logger/Logger.hpp>
 #include <configuration/GAlgConfig.hpp>
 #include "selection/SelectionStrategy.hpp"
 #include "selection/TournamentStrategy.hpp"
 #include "selection/RouletteWheelStrategy.hpp"
+#include "diversity/DiversityMonitor.hpp"
+#include "adaptation/OperatorBandit.hpp"
+#include "CrossoverFun.hpp"
 
 
 namespace ga {
@@ -25,6 +35,8 @@ class GAlg
 {
 public:
 	using IndividualPtr = std::unique_ptr<Individual>;
+	using ImprovementCallback = std::function<void(const Individual& best, const uint32_t populationsNum)>;
+	using StopPredicate = std::function<bool(void)>;
 
 	GAlg(const config::GAlgParams& params, std::function<IndividualPtr(void)> createRandomFun, logging::Logger& logger);
 
@@ -38,6 +50,9 @@ public:
 
 	void run();
 	IndividualPtr getBestIndividual() const;
+	void setImprovementCallback(ImprovementCallback callback);  // called from run() on every new best individual
+	void requestStop();  // thread-safe, run() returns after current population
+	void setStopPredicate(StopPredicate predicate);  // checked from run() after every population, true stops it
 
 private:
 
@@ -45,26 +60,83 @@ private:
 	void evaluate();
 	void gaLoop();
 	void selection();
+	std::vector<uint32_t> selectElitesIndices() const;
 	void insertToNextPopulation(const Individual& parent1, const Individual& parent2, std::vector<IndividualPtr>& nextPopulation);
+	void chooseOperators(const Individual& parent1, const Individual& parent2);
+	bool drawCrossover();
+	bool drawMutation();
+	const CrossoverFun<Individual>& getCrossoverFun() const;
+	void recordBreeding(const std::vector<IndividualPtr>& nextPopulation, const size_t firstOffspring, const Tp breedingStart);
+	void markEvaluatedOffsprings();
+	void creditOperators(const SteadyClock::duration evaluationDuration);
 	void proceedWithOneParentInsertion(const Individual& parent1, const Individual& parent2, std::vector<IndividualPtr>& nextPopulation);
 	void proceedWithBothParentsInsertion(const Individual& parent1, const Individual& parent2, std::vector<IndividualPtr>& nextPopulation);
 	void followWithMutation(Individual& individual);
+	void pushToNextPopulation(IndividualPtr individual, std::vector<IndividualPtr>& nextPopulation);
+	void screenWithSurrogate(std::vector<IndividualPtr>& candidates);
+	void measureSurrogate();
+	void packElitesExactly();
 	bool checkStopConditions();
 	std::unique_ptr<SelectionStrategy<Individual>> makeSelectionStrategy() const;
 
 	bool timeStopCondition();
 	bool populationsNumStopCondition();
 	void setBestIndividualSoFar();
+	void monitorDiversity();
+	void injectDiversity();
 
 	void logState() const;
 
+	// arms chosen for one breeding and what its offsprings cost
+	struct BreedingRecord
+	{
+		uint32_t crossoverTypeArm;
+		uint32_t crossoverProbArm;
+		uint32_t mutationProbArm;
+		double parentFitness;  // better of parents
+		double seconds;
+		bool isCrossedOver;  // crossover type arm is credited only then, clones don't come from it
+		bool isEvaluated;  // set just before evaluation, unmutated clones keep parent fitness
+	};
+
 	config::GAlgParams params;
 	std::function<IndividualPtr(void)> createRandomFun;
 
 	std::unique_ptr<SelectionStrategy<Individual>> selectionStrategy;
+	CrossoverFun<Individual> crossoverFun;
+	utils::rnd::BernoulliBatch crossoverTrials;
+	utils::rnd::BernoulliBatch mutationTrials;
+	std::unique_ptr<DiversityMonitor<Individual>> diversityMonitor;
+	DiversityStats diversityStats;
+
+	// adaptive operator selection, bandits are empty when it is off
+	std::vector<CrossoverFun<Individual>> adaptiveCrossoverFuns;
+	std::vector<double> crossoverProbLevels;
+	std::vector<double> mutationProbLevels;
+	std::unique_ptr<OperatorBandit> crossoverTypeBandit;
+	std::unique_ptr<OperatorBandit> crossoverProbBandit;
+	std::unique_ptr<OperatorBandit> mutationProbBandit;
+	BreedingRecord currentBreeding;
+	std::unordered_map<const Individual*, BreedingRecord> breedingRecords;  // offsprings of current selection
 
 	std::vector<IndividualPtr> population;
+	uint32_t offspringsNum;  // individuals bred in current selection, the rest are elites
+	uint32_t candidatesNum;  // offsprings bred before surrogate screening, equal to offspringsNum when screening is off
+	// estimates of offsprings which passed screening and weren't evaluated before it, with their population positions;
+	// unmutated clones carry exact fitness, so they would inflate the correlation
+	std::vector<double> surrogateEstimates;
+	std::vector<uint32_t> surrogateEstimatedPositions;
+	double surrogateRankCorrelation;  // between estimates and fitnesses of current estimated offsprings
+	uint64_t evaluationsSaved;
+	bool exactPackingEnabled;  // turned off when instance is too big for exact packing
+	std::unordered_set<uint64_t> exactlyPackedTours;  // keys of oriented tours of current repacked elites, at most exactPackingElites
+	IndividualPtr bestExactlyPacked;
+	std::unordered_set<uint64_t> nextPopulationTourHashes;
+	uint32_t duplicatesRejectionsLeft;
 	IndividualPtr bestIndividualSoFar;
+	ImprovementCallback improvementCallback;
+	StopPredicate stopPredicate;
+	std::atomic<bool> stopRequested;
 	logging::Logger& logger;
 	Tp startTimestamp;
 	uint32_t populationsNum;
@@ -75,10 +147,36 @@ GAlg<Individual>::GAlg(const config::GAlgParams& params, std::function<Individua
 	: params(params)
 	, createRandomFun(std::move(createRandomFun))
 	, selectionStrategy(makeSelectionStrategy())
+	, crossoverFun(makeCrossoverFun<Individual>(params.crossoverType))
+	, crossoverTrials(params.crossoverProb, params.populationSize)
+	, mutationTrials(params.mutationProb, params.populationSize)
+	, diversityMonitor(params.diversityMonitor ? std::make_unique<DiversityMonitor<Individual>>(params.diversitySamplePairs) : nullptr)
+	, diversityStats{ 0.0, 0.0, 0.0 }
+	, currentBreeding{ 0u, 0u, 0u, 0.0, 0.0, false, false }
+	, offspringsNum(params.populationSize)
+	, candidatesNum(params.populationSize)
+	, surrogateRankCorrelation(0.0)
+	, evaluationsSaved(0u)
+	, exactPackingEnabled(params.exactPackingElites != 0)
+	, duplicatesRejectionsLeft(0)
+	, stopRequested(false)
 	, logger(logger)
 	, populationsNum(0)
 {
+	if (params.surrogateOversampling < 1.0)
+		throw std::runtime_error("Surrogate oversampling ratio can't be lower than 1");
 	population.reserve(params.populationSize);
+	if (params.adaptiveOperators)
+	{
+		// probability levels around configured ones
+		for (const auto& crossoverType : params.adaptiveCrossoverTypes)
+			adaptiveCrossoverFuns.push_back(makeCrossoverFun<Individual>(crossoverType));
+		crossoverProbLevels = { params.crossoverProb / 2.0, params.crossoverProb, std::min(1.0, params.crossoverProb * 2.0) };
+		mutationProbLevels = { params.mutationProb / 2.0, params.mutationProb, std::min(1.0, params.mutationProb * 2.0) };
+		crossoverTypeBandit = std::make_unique<OperatorBandit>(static_cast<uint32_t>(adaptiveCrossoverFuns.size()));
+		crossoverProbBandit = std::make_unique<OperatorBandit>(static_cast<uint32_t>(crossoverProbLevels.size()));
+		mutationProbBandit = std::make_unique<OperatorBandit>(static_cast<uint32_t>(mutationProbLevels.size()));
+	}
 }
 
 template<class Individual>
@@ -87,7 +185,9 @@ void GAlg<Individual>::run()
 	startTimestamp = SteadyClock::now();
 	initialize();
 	evaluate();
+	packElitesExactly();
 	setBestIndividualSoFar();
+	monitorDiversity();
 	logState();
 	gaLoop();
 }
@@ -98,6 +198,24 @@ typename GAlg<Individual>::IndividualPtr GAlg<Individual>::getBestIndividual() c
 	return std::make_unique<Individual>(*bestIndividualSoFar);
 }
 
+template<class Individual>
+void GAlg<Individual>::setImprovementCallback(ImprovementCallback callback)
+{
+	improvementCallback = std::move(callback);
+}
+
+template<class Individual>
+void GAlg<Individual>::requestStop()
+{
+	stopRequested = true;
+}
+
+template<class Individual>
+void GAlg<Individual>::setStopPredicate(StopPredicate predicate)
+{
+	stopPredicate = std::move(predicate);
+}
+
 template<class Individual>
 void GAlg<Individual>::initialize()
 {
@@ -108,7 +226,7 @@ void GAlg<Individual>::initialize()
 template<class Individual>
 void GAlg<Individual>::evaluate()
 {
-	std::for_each(population.begin(), population.end(), [](auto& individual) {individual->evaluate(); });
+	Individual::evaluateAll(population);
 }
 
 template<class Individual>
@@ -117,60 +235,199 @@ void GAlg<Individual>::gaLoop()
 	while (!checkStopConditions())
 	{
 		selection();
+		markEvaluatedOffsprings();
+		const auto evaluationStart = SteadyClock::now();
 		evaluate();
+		creditOperators(SteadyClock::now() - evaluationStart);
+		measureSurrogate();
+		packElitesExactly();
 		populationsNum++;
 		setBestIndividualSoFar();
+		monitorDiversity();
 		logState();
+		if (diversityMonitor != nullptr && diversityStats.distinctToursRatio < params.diversityInjectionThreshold)
+			injectDiversity();
 	}
 }
 
 template<class Individual>
 void GAlg<Individual>::selection()
 {
+	const auto elitesIndices = selectElitesIndices();
+	offspringsNum = params.populationSize - static_cast<uint32_t>(elitesIndices.size());
+	candidatesNum = static_cast<uint32_t>(std::ceil(offspringsNum * params.surrogateOversampling));
+	nextPopulationTourHashes.clear();
+	breedingRecords.clear();
+	duplicatesRejectionsLeft = params.populationSize;  // bounds extra breeding when population is already collapsed
+	if (params.eliminateDuplicates)
+	{
+		for (const auto index : elitesIndices)
+			nextPopulationTourHashes.insert(population[index]->getTourHash());
+	}
+
 	std::vector<IndividualPtr> nextPopulation;
-	nextPopulation.reserve(params.populationSize);
-	while(nextPopulation.size() != params.populationSize)
+	nextPopulation.reserve(candidatesNum + elitesIndices.size());
+	while(nextPopulation.size() != candidatesNum)
 	{
 		const Individual& parent1 = selectionStrategy->selectParent(population);
 		const Individual& parent2 = selectionStrategy->selectParent(population);
 		insertToNextPopulation(parent1, parent2, nextPopulation);
 	}
+	if (candidatesNum != offspringsNum)
+		screenWithSurrogate(nextPopulation);
+	// parents are not needed anymore, elites are moved instead of copied
+	for (const auto index : elitesIndices)
+		nextPopulation.push_back(std::move(population[index]));
 	population = std::move(nextPopulation);
 }
 
+template<class Individual>
+std::vector<uint32_t> GAlg<Individual>::selectElitesIndices() const
+{
+	const auto elitesNum = std::min(params.elitismSize, static_cast<uint32_t>(population.size()));
+	if (elitesNum == 0)
+		return {};
+	std::vector<uint32_t> indices(population.size());
+	std::iota(indices.begin(), indices.end(), 0u);
+	auto fitnessDescending = [this](const auto lhs, const auto rhs) {
+		return population[lhs]->getCurrentFitness() > population[rhs]->getCurrentFitness(); };
+	if (!params.eliminateDuplicates)
+	{
+		std::partial_sort(indices.begin(), std::next(indices.begin(), elitesNum), indices.end(), fitnessDescending);
+		indices.resize(elitesNum);
+		return indices;
+	}
+	std::sort(indices.begin(), indices.end(), fitnessDescending);
+	std::vector<uint32_t> elitesIndices;
+	elitesIndices.reserve(elitesNum);
+	std::unordered_set<uint64_t> elitesTourHashes;
+	for (auto it = indices.cbegin(); it != indices.cend() && elitesIndices.size() != elitesNum; ++it)
+	{
+		if (elitesTourHashes.insert(population[*it]->getTourHash()).second)
+			elitesIndices.push_back(*it);
+	}
+	return elitesIndices;
+}
+
 template<class Individual>
 void GAlg<Individual>::insertToNextPopulation(const Individual& parent1, const Individual& parent2, std::vector<IndividualPtr>& nextPopulation)
 {
-	auto& random = utils::rnd::Random::getInstance();
-	auto crossoverRnd = random.getRandomDouble(0.0, 1.0);
-	if (crossoverRnd <= params.crossoverProb)
+	const bool isAdaptive = crossoverTypeBandit != nullptr;
+	const auto firstOffspring = nextPopulation.size();
+	const auto breedingStart = isAdaptive ? SteadyClock::now() : Tp();
+	if (isAdaptive)
+		chooseOperators(parent1, parent2);
+	currentBreeding.isCrossedOver = drawCrossover();
+	if (currentBreeding.isCrossedOver)
 	{
-		auto offspring = parent1.crossoverNrx(parent2);
-		followWithMutation(*offspring);
-		nextPopulation.push_back(std::move(offspring));
+		auto [offspring1, offspring2] = getCrossoverFun()(parent1, parent2);
+		if (candidatesNum != offspringsNum)
+			offspring1->inheritPacking(parent1);
+		followWithMutation(*offspring1);
+		pushToNextPopulation(std::move(offspring1), nextPopulation);
+		if (offspring2 != nullptr && nextPopulation.size() != candidatesNum)
+		{
+			if (candidatesNum != offspringsNum)
+				offspring2->inheritPacking(parent2);
+			followWithMutation(*offspring2);
+			pushToNextPopulation(std::move(offspring2), nextPopulation);
+		}
 	}
 	else
 	{
-		if (nextPopulation.size() == params.populationSize - 1)
+		if (nextPopulation.size() == candidatesNum - 1)
 			proceedWithOneParentInsertion(parent1, parent2, nextPopulation);
 		else
 			proceedWithBothParentsInsertion(parent1, parent2, nextPopulation);
 	}
+	if (isAdaptive)
+		recordBreeding(nextPopulation, firstOffspring, breedingStart);
+}
+
+template<class Individual>
+void GAlg<Individual>::chooseOperators(const Individual& parent1, const Individual& parent2)
+{
+	auto& random = utils::rnd::Random::getInstance();
+	currentBreeding.crossoverTypeArm = crossoverTypeBandit->selectArm(random);
+	currentBreeding.crossoverProbArm = crossoverProbBandit->selectArm(random);
+	currentBreeding.mutationProbArm = mutationProbBandit->selectArm(random);
+	currentBreeding.parentFitness = std::max(parent1.getCurrentFitness(), parent2.getCurrentFitness());
+}
+
+template<class Individual>
+bool GAlg<Individual>::drawCrossover()
+{
+	if (crossoverTypeBandit == nullptr)
+		return crossoverTrials.next();
+	return utils::rnd::Random::getInstance().getBernoulli(crossoverProbLevels[currentBreeding.crossoverProbArm]);
+}
+
+template<class Individual>
+bool GAlg<Individual>::drawMutation()
+{
+	if (crossoverTypeBandit == nullptr)
+		return mutationTrials.next();
+	return utils::rnd::Random::getInstance().getBernoulli(mutationProbLevels[currentBreeding.mutationProbArm]);
+}
 
-	//auto& random = utils::rnd::Random::getInstance();
-	//auto crossoverRnd = random.getRandomDouble(0.0, 1.0);
-	//if (crossoverRnd <= params.crossoverProb)
-	//{
-	//	auto [offspring1, offspring2] = parent1.crossoverPmx(parent2);
-	//	followWithMutation(*offspring1);
-	//	nextPopulation.push_back(std::move(offspring1));
-	//	followWithMutation(*offspring2);
-	//	nextPopulation.push_back(std::move(offspring2));
-	//}
-	//else
-	//{
-	//	proceedWithBothParentsInsertion(parent1, parent2, nextPopulation);
-	//}
+template<class Individual>
+const CrossoverFun<Individual>& GAlg<Individual>::getCrossoverFun() const
+{
+	return crossoverTypeBandit == nullptr ? crossoverFun : adaptiveCrossoverFuns[currentBreeding.crossoverTypeArm];
+}
+
+template<class Individual>
+void GAlg<Individual>::recordBreeding(const std::vector<IndividualPtr>& nextPopulation, const size_t firstOffspring, const Tp breedingStart)
+{
+	// breeding time is split evenly among offsprings which got into next population
+	if (nextPopulation.size() == firstOffspring)
+		return;
+	auto record = currentBreeding;
+	record.seconds = std::chrono::duration<double>(SteadyClock::now() - breedingStart).count() / (nextPopulation.size() - firstOffspring);
+	for (auto i = firstOffspring; i < nextPopulation.size(); i++)
+		breedingRecords[nextPopulation[i].get()] = record;  // address of dropped duplicate may be reused
+}
+
+template<class Individual>
+void GAlg<Individual>::markEvaluatedOffsprings()
+{
+	// records of screened out and dropped duplicate offsprings aren't matched, so they stay unevaluated
+	if (crossoverTypeBandit == nullptr)
+		return;
+	for (const auto& individual : population)
+	{
+		const auto recordIt = breedingRecords.find(individual.get());
+		if (recordIt != breedingRecords.end())
+			recordIt->second.isEvaluated = !individual->isEvaluated();
+	}
+}
+
+template<class Individual>
+void GAlg<Individual>::creditOperators(const SteadyClock::duration evaluationDuration)
+{
+	// credit of arm is improvement of offsprings over better parent, cost is breeding time plus share of evaluation time,
+	// which is split among offsprings actually evaluated
+	if (crossoverTypeBandit == nullptr || breedingRecords.empty())
+		return;
+	const auto evaluatedNum = std::count_if(breedingRecords.cbegin(), breedingRecords.cend(),
+		[](const auto& entry) {return entry.second.isEvaluated; });
+	const double evaluationSeconds = evaluatedNum == 0 ? 0.0 : std::chrono::duration<double>(evaluationDuration).count() / evaluatedNum;
+	for (const auto& individual : population)
+	{
+		const auto recordIt = breedingRecords.find(individual.get());
+		if (recordIt == breedingRecords.end())
+			continue;
+		const auto& record = recordIt->second;
+		const double improvement = std::max(0.0, individual->getCurrentFitness() - record.parentFitness);
+		const double seconds = record.seconds + (record.isEvaluated ? evaluationSeconds : 0.0);
+		if (record.isCrossedOver)
+			crossoverTypeBandit->addCredit(record.crossoverTypeArm, improvement, seconds);
+		crossoverProbBandit->addCredit(record.crossoverProbArm, improvement, seconds);
+		mutationProbBandit->addCredit(record.mutationProbArm, improvement, seconds);
+	}
+	crossoverTypeBandit->update();
+	crossoverProbBandit->update();
+	mutationProbBandit->update();
 }
 
 template<class Individual>
@@ -178,14 +435,13 @@ void GAlg<Individual>::proceedWithOneParentInsertion(
 	const Individual& parent1, const Individual& parent2, std::vector<IndividualPtr>& nextPopulation)
 {
 	auto& random = utils::rnd::Random::getInstance();
-	auto rndVal = random.getRandomDouble(0.0, 1.0);
 	std::unique_ptr<Individual> individual = nullptr;
-	if(rndVal < 0.5)
+	if(random.getBernoulli(0.5))
 		individual = std::make_unique<Individual>(parent1);
 	else
 		individual = std::make_unique<Individual>(parent2);
 	followWithMutation(*individual);
-	nextPopulation.push_back(std::move(individual));
+	pushToNextPopulation(std::move(individual), nextPopulation);
 }
 
 template<class Individual>
@@ -196,23 +452,109 @@ void GAlg<Individual>::proceedWithBothParentsInsertion(
 	auto individual2 = std::make_unique<Individual>(parent2);
 	followWithMutation(*individual1);
 	followWithMutation(*individual2);
-	nextPopulation.push_back(std::move(individual1));
-	nextPopulation.push_back(std::move(individual2));
+	pushToNextPopulation(std::move(individual1), nextPopulation);
+	if (nextPopulation.size() != candidatesNum)
+		pushToNextPopulation(std::move(individual2), nextPopulation);
 }
 
 template<class Individual>
 void GAlg<Individual>::followWithMutation(Individual& individual)
 {
-	auto& random = utils::rnd::Random::getInstance();
-	auto mutationRnd = random.getRandomDouble(0.0, 1.0);
-	if (mutationRnd <= params.mutationProb)
+	if (drawMutation())
 		individual.mutation();
 }
 
+template<class Individual>
+void GAlg<Individual>::pushToNextPopulation(IndividualPtr individual, std::vector<IndividualPtr>& nextPopulation)
+{
+	// clones are dropped before they get evaluated, unless population is too uniform to breed enough distinct ones
+	if (params.eliminateDuplicates && !nextPopulationTourHashes.insert(individual->getTourHash()).second && duplicatesRejectionsLeft > 0)
+	{
+		duplicatesRejectionsLeft--;
+		return;
+	}
+	nextPopulation.push_back(std::move(individual));
+}
+
+template<class Individual>
+void GAlg<Individual>::screenWithSurrogate(std::vector<IndividualPtr>& candidates)
+{
+	// only offspringsNum most promising candidates by estimate get full evaluation
+	std::vector<double> estimates;
+	Individual::estimateFitnessAll(candidates, estimates);
+	std::vector<uint32_t> indices(candidates.size());
+	std::iota(indices.begin(), indices.end(), 0u);
+	std::nth_element(indices.begin(), std::next(indices.begin(), offspringsNum), indices.end(),
+		[&estimates](const auto lhs, const auto rhs) {return estimates[lhs] > estimates[rhs]; });
+	indices.resize(offspringsNum);
+	std::vector<IndividualPtr> promising;
+	promising.reserve(params.populationSize);
+	surrogateEstimates.clear();
+	surrogateEstimatedPositions.clear();
+	for (const auto index : indices)
+	{
+		if (!candidates[index]->isEvaluated())
+		{
+			surrogateEstimates.push_back(estimates[index]);
+			surrogateEstimatedPositions.push_back(static_cast<uint32_t>(promising.size()));
+		}
+		promising.push_back(std::move(candidates[index]));
+	}
+	evaluationsSaved += candidates.size() - offspringsNum;
+	candidates = std::move(promising);
+}
+
+template<class Individual>
+void GAlg<Individual>::measureSurrogate()
+{
+	if (candidatesNum == offspringsNum)
+		return;
+	std::vector<double> fitnesses;
+	fitnesses.reserve(surrogateEstimatedPositions.size());
+	for (const auto position : surrogateEstimatedPositions)
+		fitnesses.push_back(population[position]->getCurrentFitness());
+	surrogateRankCorrelation = utils::stats::computeSpearmanCorrelation(surrogateEstimates, fitnesses);
+}
+
+template<class Individual>
+void GAlg<Individual>::packElitesExactly()
+{
+	// copies of best individuals are repacked, population keeps greedy packing, so selection compares offsprings and
+	// parents on one fitness; repacked copies only compete for best so far. Packing depends on tour start and direction,
+	// so rotation-free tour hash is keyed with the first two cities. Only keys of current elites are kept, surviving ones
+	// aren't repacked again and the set doesn't grow with generations.
+	if (!exactPackingEnabled)
+		return;
+	const auto elitesNum = std::min(params.exactPackingElites, static_cast<uint32_t>(population.size()));
+	std::vector<uint32_t> indices(population.size());
+	std::iota(indices.begin(), indices.end(), 0u);
+	std::partial_sort(indices.begin(), std::next(indices.begin(), elitesNum), indices.end(), [this](const auto lhs, const auto rhs) {
+		return population[lhs]->getCurrentFitness() > population[rhs]->getCurrentFitness(); });
+	std::unordered_set<uint64_t> elitesKeys;
+	for (auto i = 0u; i < elitesNum; i++)
+	{
+		const auto& elite = *population[indices[i]];
+		const auto& cityChain = elite.getCityChain();
+		const auto key = elite.getTourHash() * 0x9e3779b97f4a7c15ull ^
+			(static_cast<uint64_t>(cityChain.front().index) << 32 | cityChain[1 % cityChain.size()].index);
+		if (!elitesKeys.insert(key).second || exactlyPackedTours.count(key) != 0)
+			continue;
+		auto packed = std::make_unique<Individual>(elite);
+		if (!packed->packExactly(params.exactPackingMaxStates))
+		{
+			exactPackingEnabled = false;
+			return;
+		}
+		if (bestExactlyPacked == nullptr || packed->getCurrentFitness() > bestExactlyPacked->getCurrentFitness())
+			bestExactlyPacked = std::move(packed);
+	}
+	exactlyPackedTours = std::move(elitesKeys);
+}
+
 template<class Individual>
 bool GAlg<Individual>::checkStopConditions()
 {
-	return populationsNumStopCondition() || timeStopCondition();
+	return stopRequested || populationsNumStopCondition() || timeStopCondition() || (stopPredicate && stopPredicate());
 }
 
 template<class Individual>
@@ -229,7 +571,7 @@ std::unique_ptr<SelectionStrategy<Individual>> GAlg<Individual>::makeSelectionSt
 template<class Individual>
 bool GAlg<Individual>::timeStopCondition()
 {
-	if (params.maxGAlgDuration == 0s)
+	if (params.maxGAlgDuration == std::chrono::seconds::zero())
 		return false;
 	return SteadyClock::now() - startTimestamp >= params.maxGAlgDuration;
 }
@@ -248,17 +590,43 @@ void GAlg<Individual>::setBestIndividualSoFar()
 	auto bestIndividualIt =
 		std::max_element(population.cbegin(), population.cend(),
 			[](const auto& lhs, const auto& rhs) {return lhs->getCurrentFitness() < rhs->getCurrentFitness(); });
+	const Individual* candidate = bestIndividualIt->get();
+	if (bestExactlyPacked != nullptr && bestExactlyPacked->getCurrentFitness() > candidate->getCurrentFitness())
+		candidate = bestExactlyPacked.get();
 	if (bestIndividualSoFar == nullptr)
 	{
-		bestIndividualSoFar = std::make_unique<Individual>(**bestIndividualIt);
+		bestIndividualSoFar = std::make_unique<Individual>(*candidate);
 	}
 	else
 	{
-		const auto best = std::max((*bestIndividualIt).get(), bestIndividualSoFar.get(),
+		const auto best = std::max(candidate, static_cast<const Individual*>(bestIndividualSoFar.get()),
 			[](const auto& lhs, const auto& rhs) {return lhs->getCurrentFitness() < rhs->getCurrentFitness(); });
-		if (best != bestIndividualSoFar.get())
-			bestIndividualSoFar = std::make_unique<Individual>(*best);
+		if (best == bestIndividualSoFar.get())
+			return;
+		const bool isImprovement = best->getCurrentFitness() > bestIndividualSoFar->getCurrentFitness();
+		*bestIndividualSoFar = *best;
+		if (!isImprovement)
+			return;
 	}
+	if (improvementCallback)
+		improvementCallback(*bestIndividualSoFar, populationsNum);
+}
+
+template<class Individual>
+void GAlg<Individual>::monitorDiversity()
+{
+	if (diversityMonitor != nullptr)
+		diversityStats = diversityMonitor->computeStats(population);
+}
+
+template<class Individual>
+void GAlg<Individual>::injectDiversity()
+{
+	// replace clones with random individuals
+	for (const auto index : diversityMonitor->findDuplicates(population))
+		population[index] = createRandomFun();
+	evaluate();
+	setBestIndividualSoFar();
 }
 
 template<class Individual>
@@ -271,7 +639,39 @@ void GAlg<Individual>::logState() const
 	double sumOfFitnesses = std::accumulate(population.cbegin(), population.cend(), 0.0,
 		[](const auto& acc, const auto& individual) {return acc + individual->getCurrentFitness(); });
 	auto avgFitness = sumOfFitnesses / population.size();
-	logger.log("%d, %.4f, %.4f, %.4f", populationsNum, bestCurrentFitness, avgFitness, worstCurrentFitness);
+	char buffer[200];
+	std::snprintf(buffer, sizeof(buffer), "%d, %.4f, %.4f, %.4f", populationsNum, bestCurrentFitness, avgFitness, worstCurrentFitness);
+	std::string line = buffer;
+	if (diversityMonitor != nullptr)
+	{
+		std::snprintf(buffer, sizeof(buffer), ", %.4f, %.4f, %.4f",
+			diversityStats.distinctToursRatio, diversityStats.avgEdgeDistance, diversityStats.edgeEntropy);
+		line += buffer;
+	}
+	if (params.surrogateOversampling > 1.0)
+	{
+		std::snprintf(buffer, sizeof(buffer), ", %.4f, %llu", surrogateRankCorrelation, static_cast<unsigned long long>(evaluationsSaved));
+		line += buffer;
+	}
+	if (params.exactPackingElites != 0)
+	{
+		// best so far, with exactly packed copies, population columns stay on greedy packing
+		std::snprintf(buffer, sizeof(buffer), ", %.4f", bestIndividualSoFar->getCurrentFitness());
+		line += buffer;
+	}
+	if (crossoverTypeBandit != nullptr)
+	{
+		// selection probabilities of arms: crossover types as configured, then low, configured and high probability levels
+		for (const auto* bandit : { crossoverTypeBandit.get(), crossoverProbBandit.get(), mutationProbBandit.get() })
+		{
+			for (const auto probability : bandit->getProbabilities())
+			{
+				std::snprintf(buffer, sizeof(buffer), ", %.4f", probability);
+				line += buffer;
+			}
+		}
+	}
+	logger.log("%s", line.c_str());
 	//std::cout << populationsNum << ", " << bestCurrentFitness << ", " << avgFitness << ", " << worstCurrentFitness << std::endl;
 }
 
@@ -0,0 +1,107 @@
+#include "MemoryBudget.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <thread>
+
+namespace ga {
+
+namespace {
+
+constexpr uint32_t minPopulationSize = 2u;
+
+std::string formatBytes(const uint64_t bytes)
+{
+	char buffer[32];
+	if (bytes < (1u << 20))
+		std::snprintf(buffer, sizeof(buffer), "%.1f KB", bytes / 1024.0);
+	else
+		std::snprintf(buffer, sizeof(buffer), "%.1f MB", bytes / (1024.0 * 1024.0));
+	return buffer;
+}
+
+uint32_t getThreadsNum(const config::GAlgParams& params)
+{
+	return params.threadsNum != 0 ? params.threadsNum : std::max(1u, std::thread::hardware_concurrency());
+}
+
+uint32_t getMinPopulationSize(const std::string& algorithm, const config::GAlgParams& params)
+{
+	// GAlg with population not bigger than elitism only copies elites, nothing is bred
+	if (algorithm == "ga")
+		return std::max(minPopulationSize, params.elitismSize + 1);
+	return minPopulationSize;
+}
+
+} // namespace
+
+std::string MemoryFootprint::getStringRepresentation() const
+{
+	return "instance: " + formatBytes(instanceBytes) + "; individual: " + formatBytes(individualBytes) +
+		"; peak individuals: " + std::to_string(peakIndividualsNum) + "; peak: " + formatBytes(peakBytes);
+}
+
+bool isMemoryBudgetSupported(const std::string& algorithm)
+{
+	return algorithm == "ga" || algorithm == "async_ga" || algorithm == "mmas";
+}
+
+uint64_t getPeakIndividualsNum(const std::string& algorithm, const config::GAlgParams& params)
+{
+	const uint64_t populationSize = params.populationSize;
+	if (algorithm == "ga")
+	{
+		// elites are moved, not copied, the rest is bred as oversampled candidates; best so far is kept aside
+		const auto offspringsNum = populationSize - std::min<uint64_t>(params.elitismSize, populationSize);
+		const auto candidatesNum = static_cast<uint64_t>(std::ceil(offspringsNum * params.surrogateOversampling));
+		return populationSize + candidatesNum + 1;
+	}
+	if (algorithm == "async_ga")
+		return populationSize + 2 * static_cast<uint64_t>(getThreadsNum(params)) + 1;  // up to two offsprings per worker
+	if (algorithm == "mmas")
+		return populationSize + std::min<uint64_t>(getThreadsNum(params), populationSize) + 1;  // new ant built before old one is freed
+	throw std::runtime_error("Memory budget isn't supported by algorithm: " + algorithm);
+}
+
+MemoryFootprint estimateFootprint(const std::string& algorithm, const config::GAlgParams& params,
+	const uint64_t instanceBytes, const uint64_t individualBytes)
+{
+	const auto peakIndividualsNum = getPeakIndividualsNum(algorithm, params);
+	return MemoryFootprint{ instanceBytes, individualBytes, peakIndividualsNum, instanceBytes + peakIndividualsNum * individualBytes };
+}
+
+uint32_t fitPopulationSize(const std::string& algorithm, const config::GAlgParams& params,
+	const uint64_t instanceBytes, const uint64_t individualBytes, const uint64_t budgetBytes)
+{
+	auto fits = [&](const uint32_t populationSize) {
+		auto capped = params;
+		capped.populationSize = populationSize;
+		return estimateFootprint(algorithm, capped, instanceBytes, individualBytes).peakBytes <= budgetBytes;
+	};
+	if (fits(params.populationSize))
+		return params.populationSize;
+	auto minimal = params;
+	minimal.populationSize = std::min(params.populationSize, getMinPopulationSize(algorithm, params));
+	if (minimal.populationSize == params.populationSize || !fits(minimal.populationSize))
+	{
+		throw std::runtime_error("Memory budget of " + formatBytes(budgetBytes) + " is too small, population of " +
+			std::to_string(minimal.populationSize) + " needs " +
+			formatBytes(estimateFootprint(algorithm, minimal, instanceBytes, individualBytes).peakBytes));
+	}
+	// peak grows with population size, so the largest fitting one is found by bisection
+	auto low = minimal.populationSize;
+	auto high = params.populationSize;
+	while (high - low > 1)
+	{
+		const auto middle = low + (high - low) / 2;
+		if (fits(middle))
+			low = middle;
+		else
+			high = middle;
+	}
+	return low;
+}
+
+} // namespace ga
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include <configuration/GAlgConfig.hpp>
+
+namespace ga {
+
+struct MemoryFootprint
+{
+	std::string getStringRepresentation() const;
+
+	uint64_t instanceBytes;
+	uint64_t individualBytes;
+	uint64_t peakIndividualsNum;  // held at once by the engine
+	uint64_t peakBytes;  // instance and peak individuals
+};
+
+// Individuals held at once by population based engines: GAlg keeps whole population while breeding all candidates
+// of the next one, async GA and ant system build few new ones per worker before replacing old ones.
+// Engines which don't scale with population size (pt_sa, decomposition) are not covered.
+bool isMemoryBudgetSupported(const std::string& algorithm);
+uint64_t getPeakIndividualsNum(const std::string& algorithm, const config::GAlgParams& params);
+MemoryFootprint estimateFootprint(const std::string& algorithm, const config::GAlgParams& params,
+	const uint64_t instanceBytes, const uint64_t individualBytes);
+// largest population size, up to configured one, whose peak footprint fits in budget; throws when it would be below 2
+// or, for GA, not bigger than elitism size
+uint32_t fitPopulationSize(const std::string& algorithm, const config::GAlgParams& params,
+	const uint64_t instanceBytes, const uint64_t individualBytes, const uint64_t budgetBytes);
+
+} // namespace ga
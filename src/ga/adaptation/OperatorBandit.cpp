@@ -0,0 +1,64 @@
+#include "OperatorBandit.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+
+namespace ga {
+
+namespace {
+
+constexpr double adaptationRate = 0.3;
+constexpr double explorationShare = 0.2;  // of selection probability spread evenly over all arms
+
+} // namespace
+
+OperatorBandit::OperatorBandit(const uint32_t armsNum)
+	: minProbability(armsNum != 0 ? explorationShare / armsNum : 0.0)
+	, qualities(armsNum, 0.0)
+	, probabilities(armsNum, armsNum != 0 ? 1.0 / armsNum : 0.0)
+	, improvements(armsNum, 0.0)
+	, costs(armsNum, 0.0)
+{
+	if (armsNum == 0)
+		throw std::runtime_error("Operator bandit needs at least one arm");
+}
+
+uint32_t OperatorBandit::selectArm(utils::rnd::Random& random) const
+{
+	double threshold = random.getRandomDouble(0.0, 1.0);
+	auto arm = 0u;
+	for (; arm + 1 < probabilities.size() && threshold >= probabilities[arm]; arm++)
+		threshold -= probabilities[arm];
+	return arm;
+}
+
+void OperatorBandit::addCredit(const uint32_t arm, const double improvement, const double seconds)
+{
+	improvements[arm] += improvement;
+	costs[arm] += seconds;
+}
+
+void OperatorBandit::update()
+{
+	for (auto arm = 0u; arm < qualities.size(); arm++)
+	{
+		if (costs[arm] > 0.0)
+			qualities[arm] += adaptationRate * (improvements[arm] / costs[arm] - qualities[arm]);
+	}
+	const double qualitiesSum = std::accumulate(qualities.cbegin(), qualities.cend(), 0.0);
+	for (auto arm = 0u; arm < qualities.size(); arm++)
+	{
+		probabilities[arm] = qualitiesSum > 0.0 ?
+			minProbability + (1.0 - minProbability * qualities.size()) * qualities[arm] / qualitiesSum : 1.0 / qualities.size();
+	}
+	std::fill(improvements.begin(), improvements.end(), 0.0);
+	std::fill(costs.begin(), costs.end(), 0.0);
+}
+
+const std::vector<double>& OperatorBandit::getProbabilities() const
+{
+	return probabilities;
+}
+
+} // namespace ga
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include <utils/RandomUtils.hpp>
+
+namespace ga {
+
+// Probability matching bandit. Arms collect credit (fitness improvement) and cost (seconds) during a generation,
+// then quality of every used arm moves towards its improvement per second and selection probabilities follow
+// qualities, with a floor so that no arm starves and can regain its share when search phase changes.
+class OperatorBandit
+{
+public:
+	explicit OperatorBandit(const uint32_t armsNum);
+
+	uint32_t selectArm(utils::rnd::Random& random) const;
+	void addCredit(const uint32_t arm, const double improvement, const double seconds);
+	void update();  // once per generation, clears collected credit
+	const std::vector<double>& getProbabilities() const;
+
+private:
+	const double minProbability;
+	std::vector<double> qualities;
+	std::vector<double> probabilities;
+	std::vector<double> improvements;
+	std::vector<double> costs;
+};
+
+} // namespace ga
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+#include <utils/RandomUtils.hpp>
+
+namespace ga {
+
+struct DiversityStats
+{
+	double distinctToursRatio;  // distinct tours / population size
+	double avgEdgeDistance;  // sampled pairs, share of edges not common for both tours, 0 - identical, 1 - disjoint
+	double edgeEntropy;  // normalized, 0 - all tours identical, 1 - every edge unique in population
+};
+
+template <class Individual>
+class DiversityMonitor
+{
+public:
+	using IndividualPtr = std::unique_ptr<Individual>;
+
+	explicit DiversityMonitor(const uint32_t samplePairsNum);
+
+	DiversityStats computeStats(const std::vector<IndividualPtr>& population);
+	std::vector<uint32_t> findDuplicates(const std::vector<IndividualPtr>& population) const;
+
+private:
+	void gatherTours(const std::vector<IndividualPtr>& population);
+	double computeDistinctToursRatio(const std::vector<IndividualPtr>& population) const;
+	double computeAvgEdgeDistance(const uint32_t individualsNum);
+	double computeEdgeEntropy(const uint32_t individualsNum);
+
+	const uint32_t samplePairsNum;
+	uint32_t citiesNum;
+	std::vector<uint32_t> tours;  // flat, citiesNum ids per individual
+	std::vector<uint32_t> successors;
+	std::vector<uint32_t> predecessors;
+	std::vector<uint64_t> edgeKeys;
+};
+
+template<class Individual>
+DiversityMonitor<Individual>::DiversityMonitor(const uint32_t samplePairsNum)
+	: samplePairsNum(samplePairsNum)
+	, citiesNum(0u)
+{
+}
+
+template<class Individual>
+DiversityStats DiversityMonitor<Individual>::computeStats(const std::vector<IndividualPtr>& population)
+{
+	if (population.empty())
+		return DiversityStats{ 0.0, 0.0, 0.0 };
+	gatherTours(population);
+	const auto individualsNum = static_cast<uint32_t>(population.size());
+	return DiversityStats{
+		computeDistinctToursRatio(population),
+		computeAvgEdgeDistance(individualsNum),
+		computeEdgeEntropy(individualsNum)
+	};
+}
+
+template<class Individual>
+std::vector<uint32_t> DiversityMonitor<Individual>::findDuplicates(const std::vector<IndividualPtr>& population) const
+{
+	// indices of all but first occurrence of each tour
+	std::vector<uint32_t> duplicates;
+	std::unordered_set<uint64_t> seen;
+	seen.reserve(population.size());
+	for (auto i = 0u; i < population.size(); i++)
+	{
+		if (!seen.insert(population[i]->getTourHash()).second)
+			duplicates.push_back(i);
+	}
+	return duplicates;
+}
+
+template<class Individual>
+void DiversityMonitor<Individual>::gatherTours(const std::vector<IndividualPtr>& population)
+{
+	citiesNum = static_cast<uint32_t>(population.front()->getCityChain().size());
+	tours.resize(static_cast<size_t>(citiesNum) * population.size());
+	auto out = tours.begin();
+	for (const auto& individual : population)
+		out = std::transform(individual->getCityChain().cbegin(), individual->getCityChain().cend(), out,
+			[](const auto& city) {return city.index; });
+}
+
+template<class Individual>
+double DiversityMonitor<Individual>::computeDistinctToursRatio(const std::vector<IndividualPtr>& population) const
+{
+	std::unordered_set<uint64_t> hashes;
+	hashes.reserve(population.size());
+	for (const auto& individual : population)
+		hashes.insert(individual->getTourHash());
+	return static_cast<double>(hashes.size()) / population.size();
+}
+
+template<class Individual>
+double DiversityMonitor<Individual>::computeAvgEdgeDistance(const uint32_t individualsNum)
+{
+	if (individualsNum < 2 || citiesNum < 2 || samplePairsNum == 0)
+		return 0.0;
+	successors.resize(citiesNum + 1);
+	predecessors.resize(citiesNum + 1);
+	auto& random = utils::rnd::Random::getInstance();
+	double distanceSum = 0.0;
+	for (auto k = 0u; k < samplePairsNum; k++)
+	{
+		auto first = random.getRandomUint(0, individualsNum - 1);
+		auto second = random.getRandomUint(0, individualsNum - 2);
+		if (second >= first)
+			second++;
+		const auto* tour1 = &tours[static_cast<size_t>(first) * citiesNum];
+		const auto* tour2 = &tours[static_cast<size_t>(second) * citiesNum];
+		for (auto i = 0u; i < citiesNum; i++)
+		{
+			auto next = tour1[i + 1 == citiesNum ? 0 : i + 1];
+			successors[tour1[i]] = next;
+			predecessors[next] = tour1[i];
+		}
+		uint32_t commonEdges = 0u;
+		for (auto i = 0u; i < citiesNum; i++)
+		{
+			auto from = tour2[i];
+			auto to = tour2[i + 1 == citiesNum ? 0 : i + 1];
+			commonEdges += (successors[from] == to) | (predecessors[from] == to);
+		}
+		distanceSum += 1.0 - static_cast<double>(commonEdges) / citiesNum;
+	}
+	return distanceSum / samplePairsNum;
+}
+
+template<class Individual>
+double DiversityMonitor<Individual>::computeEdgeEntropy(const uint32_t individualsNum)
+{
+	if (individualsNum < 2 || citiesNum < 2)
+		return 0.0;
+	// undirected edges encoded as (smaller id, bigger id), counted by sorting instead of hashing
+	edgeKeys.resize(tours.size());
+	for (auto t = 0u; t < individualsNum; t++)
+	{
+		const auto* tour = &tours[static_cast<size_t>(t) * citiesNum];
+		for (auto i = 0u; i < citiesNum; i++)
+		{
+			uint64_t from = tour[i];
+			uint64_t to = tour[i + 1 == citiesNum ? 0 : i + 1];
+			edgeKeys[static_cast<size_t>(t) * citiesNum + i] = from < to ? (from << 32) | to : (to << 32) | from;
+		}
+	}
+	std::sort(edgeKeys.begin(), edgeKeys.end());
+	const double total = static_cast<double>(edgeKeys.size());
+	double entropy = 0.0;
+	for (auto runStart = edgeKeys.cbegin(); runStart != edgeKeys.cend();)
+	{
+		auto runEnd = std::find_if(runStart, edgeKeys.cend(), [key = *runStart](const auto edge) {return edge != key; });
+		const double probability = std::distance(runStart, runEnd) / total;
+		entropy -= probability * std::log(probability);
+		runStart = runEnd;
+	}
+	// entropy of identical tours is log(citiesNum), of tours with no common edges log(citiesNum * individualsNum)
+	return std::max(0.0, (entropy - std::log(static_cast<double>(citiesNum))) / std::log(static_cast<double>(individualsNum)));
+}
+
+} // namespace ga
@@ -34,24 +34,18 @@ TournamentStrategy<Individual>::TournamentStrategy(const uint32_t tournamentSize
 template<class Individual>
 const Individual& TournamentStrategy<Individual>::selectParent(const std::vector<IndividualPtr>& population) const
 {
-	// tournament
+	// tournament, contestants drawn in one bulk call
+	thread_local std::vector<uint32_t> contestantsIndices;
+	contestantsIndices.resize(tournamentSize);
 	auto& random = utils::rnd::Random::getInstance();
-	//std::vector<Individual*> tournamentBatch;
-	//tournamentBatch.reserve(tournamentSize);
-	auto individualIndex = random.getRandomUint(0, static_cast<uint32_t>(population.size() - 1));
-	Individual* winner = population[individualIndex].get();
-	for (auto j = 0u; j < tournamentSize - 1; j++)
+	random.fillRandomUints(contestantsIndices.data(), tournamentSize, 0, static_cast<uint32_t>(population.size() - 1));
+	Individual* winner = population[contestantsIndices[0]].get();
+	for (auto j = 1u; j < tournamentSize; j++)
 	{
-		individualIndex = random.getRandomUint(0, static_cast<uint32_t>(population.size() - 1));
-		Individual* tmp = population[individualIndex].get();
+		Individual* tmp = population[contestantsIndices[j]].get();
 		if (tmp->getCurrentFitness() > winner->getCurrentFitness())
 			winner = tmp;
-		//tournamentBatch.push_back(population[individualIndex].get());
 	}
-	/*auto tournamentWinnerIt =
-		std::min_element(tournamentBatch.cbegin(), tournamentBatch.cend(),
-			[](const auto& lhs, const auto& rhs) {return lhs->getCurrentFitness() < rhs->getCurrentFitness(); });*/
-	//return **tournamentWinnerIt;
 	return *winner;
 }
 
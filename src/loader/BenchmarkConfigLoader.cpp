@@ -0,0 +1,73 @@
+#include "BenchmarkConfigLoader.hpp"
+
+#include <chrono>
+#include <fstream>
+
+#include "ConfigParsingException.hpp"
+#include <utils/StringUtils.hpp>
+
+namespace loader {
+
+config::BenchmarkConfig BenchmarkConfigLoader::loadBenchmarkConfig(const std::string& filePath) const
+{
+	std::ifstream fileHandle(filePath);
+	if (!fileHandle.is_open())
+		throw std::runtime_error("Could not read file: " + filePath);
+
+	config::BenchmarkConfig benchmarkConfig;
+	std::string line;
+	while (std::getline(fileHandle, line))
+	{
+		decideWhatToDoWithLine(line, benchmarkConfig);
+	}
+
+	if (benchmarkConfig.instanceFilePaths.empty())
+		throw ConfigParsingException("No benchmark instances given");
+	return benchmarkConfig;
+}
+
+void BenchmarkConfigLoader::decideWhatToDoWithLine(const std::string& line, config::BenchmarkConfig& benchmarkConfig) const
+{
+	if (line.find("BENCHMARK INSTANCES:") != std::string::npos)
+	{
+		benchmarkConfig.instanceFilePaths = utils::str::split(prepareValueToStore(line));
+	}
+	else if (line.find("RUNS NUM:") != std::string::npos)
+	{
+		auto value = prepareValueToStore(line);
+		benchmarkConfig.runsNum = std::stoi(value);
+	}
+	else if (line.find("RUN SECONDS DURATION:") != std::string::npos)
+	{
+		auto value = prepareValueToStore(line);
+		benchmarkConfig.runDuration = std::chrono::seconds(std::stoi(value));
+	}
+	else if (line.find("SAMPLING INTERVAL MS:") != std::string::npos)
+	{
+		auto value = prepareValueToStore(line);
+		benchmarkConfig.samplingInterval = std::chrono::milliseconds(std::stoi(value));
+	}
+	else if (line.find("TARGET GAPS:") != std::string::npos)
+	{
+		benchmarkConfig.targetGaps.clear();
+		for (const auto& value : utils::str::split(prepareValueToStore(line)))
+			benchmarkConfig.targetGaps.push_back(std::stod(value));
+	}
+	else if (line.find("RESULTS CSV PREFIX:") != std::string::npos)
+	{
+		auto value = prepareValueToStore(line);
+		benchmarkConfig.resultsCsvPrefix = value;
+	}
+}
+
+std::string BenchmarkConfigLoader::prepareValueToStore(const std::string & s) const
+{
+	auto pos = s.find(':');
+	if (pos == std::string::npos)
+		throw ConfigParsingException("Bad file structure at line: \"" + s + "\"");
+	auto value = s.substr(pos + 1, s.length() - pos - 1);
+	utils::str::trim(value);
+	return value;
+}
+
+} // namespace loader
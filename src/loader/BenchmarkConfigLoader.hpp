@@ -0,0 +1,19 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <configuration/BenchmarkConfig.hpp>
+
+
+namespace loader {
+
+class BenchmarkConfigLoader
+{
+public:
+	config::BenchmarkConfig loadBenchmarkConfig(const std::string& filePath) const;
+
+private:
+	void decideWhatToDoWithLine(const std::string& line, config::BenchmarkConfig& benchmarkConfig) const;
+	std::string prepareValueToStore(const std::string& s) const;
+};
+} // namespace loader
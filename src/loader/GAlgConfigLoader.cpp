@@ -56,6 +56,130 @@ void GAlgConfigLoader::decideWhatToDoWithLine(const std::string& line, config::G
 		auto value = prepareValueToStore(line);
 		gAlgConfig.naiveRepetitions = std::stoi(value);
 	}
+	else if (line.find("RANDOM SEED:") != std::string::npos)
+	{
+		auto value = prepareValueToStore(line);
+		gAlgConfig.randomSeed = std::stoull(value);
+	}
+	else if (line.find("PRUNE UNPROFITABLE ITEMS:") != std::string::npos)
+	{
+		auto value = prepareValueToStore(line);
+		gAlgConfig.pruneUnprofitableItems = std::stoi(value) != 0;
+	}
+	else if (line.find("EVALUATION PRECISION:") != std::string::npos)
+	{
+		auto value = prepareValueToStore(line);
+		gAlgConfig.evaluationPrecision = value;
+	}
+	else if (line.find("RENUMBER CITIES:") != std::string::npos)
+	{
+		auto value = prepareValueToStore(line);
+		gAlgConfig.renumberCities = std::stoi(value) != 0;
+	}
+	else if (line.find("PRUNE DOMINATED ITEMS:") != std::string::npos)
+	{
+		auto value = prepareValueToStore(line);
+		gAlgConfig.pruneDominatedItems = std::stoi(value) != 0;
+	}
+	else if (line.find("SURROGATE OVERSAMPLING:") != std::string::npos)
+	{
+		auto value = prepareValueToStore(line);
+		gAlgConfig.gAlgParams.surrogateOversampling = std::stod(value);
+	}
+	else if (line.find("ADAPTIVE OPERATORS:") != std::string::npos)
+	{
+		auto value = prepareValueToStore(line);
+		gAlgConfig.gAlgParams.adaptiveOperators = std::stoi(value) != 0;
+	}
+	else if (line.find("ADAPTIVE CROSSOVER TYPES:") != std::string::npos)
+	{
+		gAlgConfig.gAlgParams.adaptiveCrossoverTypes = utils::str::split(prepareValueToStore(line));
+	}
+	else if (line.find("EXACT PACKING ELITES:") != std::string::npos)
+	{
+		auto value = prepareValueToStore(line);
+		gAlgConfig.gAlgParams.exactPackingElites = std::stoi(value);
+	}
+	else if (line.find("EXACT PACKING MAX STATES:") != std::string::npos)
+	{
+		auto value = prepareValueToStore(line);
+		gAlgConfig.gAlgParams.exactPackingMaxStates = std::stoull(value);
+	}
+	else if (line.find("ALGORITHM:") != std::string::npos)
+	{
+		auto value = prepareValueToStore(line);
+		gAlgConfig.algorithm = value;
+	}
+	else if (line.find("THREADS:") != std::string::npos)
+	{
+		auto value = prepareValueToStore(line);
+		gAlgConfig.gAlgParams.threadsNum = std::stoi(value);
+	}
+	else if (line.find("SA CHAINS NUM:") != std::string::npos)
+	{
+		auto value = prepareValueToStore(line);
+		gAlgConfig.saParams.chainsNum = std::stoi(value);
+	}
+	else if (line.find("SA MOVES PER EXCHANGE:") != std::string::npos)
+	{
+		auto value = prepareValueToStore(line);
+		gAlgConfig.saParams.movesPerExchange = std::stoi(value);
+	}
+	else if (line.find("SA MAX TEMPERATURE:") != std::string::npos)
+	{
+		auto value = prepareValueToStore(line);
+		gAlgConfig.saParams.maxTemperature = std::stod(value);
+	}
+	else if (line.find("SA MIN TEMPERATURE:") != std::string::npos)
+	{
+		auto value = prepareValueToStore(line);
+		gAlgConfig.saParams.minTemperature = std::stod(value);
+	}
+	else if (line.find("ACO CANDIDATES NUM:") != std::string::npos)
+	{
+		auto value = prepareValueToStore(line);
+		gAlgConfig.acoParams.candidatesNum = std::stoi(value);
+	}
+	else if (line.find("ACO ALPHA:") != std::string::npos)
+	{
+		auto value = prepareValueToStore(line);
+		gAlgConfig.acoParams.alpha = std::stod(value);
+	}
+	else if (line.find("ACO BETA:") != std::string::npos)
+	{
+		auto value = prepareValueToStore(line);
+		gAlgConfig.acoParams.beta = std::stod(value);
+	}
+	else if (line.find("ACO EVAPORATION RATE:") != std::string::npos)
+	{
+		auto value = prepareValueToStore(line);
+		gAlgConfig.acoParams.evaporationRate = std::stod(value);
+	}
+	else if (line.find("DECOMPOSITION CLUSTER SIZE:") != std::string::npos)
+	{
+		auto value = prepareValueToStore(line);
+		gAlgConfig.decompositionParams.clusterSize = std::stoi(value);
+	}
+	else if (line.find("THREAD PINNING:") != std::string::npos)
+	{
+		auto value = prepareValueToStore(line);
+		gAlgConfig.threadPinning = value;
+	}
+	else if (line.find("NUMA NODE:") != std::string::npos)
+	{
+		auto value = prepareValueToStore(line);
+		gAlgConfig.numaNode = value == "auto" ? -2 : std::stoi(value);
+	}
+	else if (line.find("HUGE PAGES:") != std::string::npos)
+	{
+		auto value = prepareValueToStore(line);
+		gAlgConfig.hugePages = std::stoi(value) != 0;
+	}
+	else if (line.find("MEMORY BUDGET:") != std::string::npos)
+	{
+		auto value = prepareValueToStore(line);
+		gAlgConfig.memoryBudgetMb = std::stoull(value);
+	}
 	else if (line.find("POPULATION SIZE:") != std::string::npos)
 	{
 		auto value = prepareValueToStore(line);
@@ -91,6 +215,36 @@ void GAlgConfigLoader::decideWhatToDoWithLine(const std::string& line, config::G
 		auto value = prepareValueToStore(line);
 		gAlgConfig.gAlgParams.mutationProb = std::stod(value);
 	}
+	else if (line.find("CROSSOVER TYPE:") != std::string::npos)
+	{
+		auto value = prepareValueToStore(line);
+		gAlgConfig.gAlgParams.crossoverType = value;
+	}
+	else if (line.find("DIVERSITY MONITOR:") != std::string::npos)
+	{
+		auto value = prepareValueToStore(line);
+		gAlgConfig.gAlgParams.diversityMonitor = std::stoi(value) != 0;
+	}
+	else if (line.find("DIVERSITY SAMPLE PAIRS:") != std::string::npos)
+	{
+		auto value = prepareValueToStore(line);
+		gAlgConfig.gAlgParams.diversitySamplePairs = std::stoi(value);
+	}
+	else if (line.find("DIVERSITY INJECTION THRESHOLD:") != std::string::npos)
+	{
+		auto value = prepareValueToStore(line);
+		gAlgConfig.gAlgParams.diversityInjectionThreshold = std::stod(value);
+	}
+	else if (line.find("ELITISM SIZE:") != std::string::npos)
+	{
+		auto value = prepareValueToStore(line);
+		gAlgConfig.gAlgParams.elitismSize = std::stoi(value);
+	}
+	else if (line.find("ELIMINATE DUPLICATES:") != std::string::npos)
+	{
+		auto value = prepareValueToStore(line);
+		gAlgConfig.gAlgParams.eliminateDuplicates = std::stoi(value) != 0;
+	}
 }
 
 std::string GAlgConfigLoader::prepareValueToStore(const std::string & s) const
@@ -12,6 +12,22 @@ namespace loader
 {
 
 config::TtpConfigBase InstanceLoader::loadTtpConfig(const std::string& filePath) const
+{
+	auto ttpConfig = parseTtpConfig(filePath);
+	ttpConfig.fillRankedItemsPerCity();
+	return config::TtpConfigBase(std::move(ttpConfig));
+}
+
+config::TtpConfigBase InstanceLoader::loadTtpConfig(const std::string& filePath,
+	const InstancePreprocessor& preprocessor, PreprocessingReport& report) const
+{
+	auto ttpConfig = parseTtpConfig(filePath);
+	report = preprocessor.preprocess(ttpConfig);
+	ttpConfig.fillRankedItemsPerCity();
+	return config::TtpConfigBase(std::move(ttpConfig));
+}
+
+config::TtpConfig InstanceLoader::parseTtpConfig(const std::string& filePath) const
 {
 	std::ifstream fileHandle(filePath);
 	if (!fileHandle.is_open())
@@ -26,7 +42,7 @@ config::TtpConfigBase InstanceLoader::loadTtpConfig(const std::string& filePath)
 	}
 
 	ttpConfig.fillNearestDistanceLookup();
-	return config::TtpConfigBase(std::move(ttpConfig));
+	return ttpConfig;
 }
 
 void InstanceLoader::decideWhatToDoWithLine(const std::string& line, ReadingType& readingType, config::TtpConfig& ttpConfig) const
@@ -3,6 +3,7 @@
 #include <string>
 #include <configuration/TtpConfigBase.hpp>
 #include <configuration/TtpConfig.hpp>
+#include "InstancePreprocessor.hpp"
 
 
 namespace loader {
@@ -17,8 +18,11 @@ class InstanceLoader
 {
 public:
 	config::TtpConfigBase loadTtpConfig(const std::string& filePath) const;
+	config::TtpConfigBase loadTtpConfig(const std::string& filePath,
+		const InstancePreprocessor& preprocessor, PreprocessingReport& report) const;
 
 private:
+	config::TtpConfig parseTtpConfig(const std::string& filePath) const;
 	void decideWhatToDoWithLine(const std::string& line, ReadingType& readingType, config::TtpConfig& ttpConfig) const;
 	std::string prepareValueToStore(const std::string& s) const;
 	void storeCityData(const std::string& line, config::TtpConfig& ttpConfig) const;
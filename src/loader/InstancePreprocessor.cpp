@@ -0,0 +1,154 @@
+#include "InstancePreprocessor.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <utils/GeometryUtils.hpp>
+
+namespace loader {
+
+std::string PreprocessingReport::getStringRepresentation() const
+{
+	return "items: " + std::to_string(itemsBefore) + " -> " + std::to_string(itemsAfter) +
+		" (overweight: " + std::to_string(overweightItemsRemoved) +
+		", unprofitable: " + std::to_string(unprofitableItemsRemoved) +
+		", dominated: " + std::to_string(dominatedItemsRemoved) +
+		"); cities without items: " + std::to_string(citiesWithoutItems) +
+		"; cities renumbered: " + (citiesRenumbered ? "yes" : "no");
+}
+
+InstancePreprocessor::InstancePreprocessor(const PreprocessingOptions& options)
+	: options(options)
+{
+}
+
+PreprocessingReport InstancePreprocessor::preprocess(config::TtpConfig& ttpConfig) const
+{
+	PreprocessingReport report{ static_cast<uint32_t>(ttpConfig.items.size()), 0u, 0u, 0u, 0u, 0u, false };
+	std::vector<bool> dominated =
+		options.pruneDominatedItems ? findDominatedItems(ttpConfig) : std::vector<bool>(ttpConfig.items.size(), false);
+	std::vector<ttp::Item> keptItems;
+	keptItems.reserve(ttpConfig.items.size());
+	for (auto i = 0u; i < ttpConfig.items.size(); i++)
+	{
+		const auto& item = ttpConfig.items[i];
+		if (options.pruneUnprofitableItems && isOverweight(item, ttpConfig))
+			report.overweightItemsRemoved++;
+		else if (options.pruneUnprofitableItems && isUnprofitable(item, ttpConfig))
+			report.unprofitableItemsRemoved++;
+		else if (dominated[i])
+			report.dominatedItemsRemoved++;
+		else
+			keptItems.push_back(item);
+	}
+	ttpConfig.items = std::move(keptItems);
+	ttpConfig.itemsNum = static_cast<uint32_t>(ttpConfig.items.size());
+	report.itemsAfter = ttpConfig.itemsNum;
+
+	std::vector<bool> hasItems(ttpConfig.cities.size() + 1, false);
+	for (const auto& item : ttpConfig.items)
+		hasItems[item.cityId] = true;
+	report.citiesWithoutItems = static_cast<uint32_t>(std::count(hasItems.cbegin() + 1, hasItems.cend(), false));
+
+	if (options.renumberCitiesAlongHilbertCurve)
+	{
+		renumberCitiesAlongHilbertCurve(ttpConfig);
+		report.citiesRenumbered = true;
+	}
+	return report;
+}
+
+bool InstancePreprocessor::isOverweight(const ttp::Item& item, const config::TtpConfig& ttpConfig) const
+{
+	// item heavier than knapsack fits in no solution, one of exactly its capacity still may
+	return item.weight > ttpConfig.capacityOfKnapsack;
+}
+
+bool InstancePreprocessor::isUnprofitable(const ttp::Item& item, const config::TtpConfig& ttpConfig) const
+{
+	// item is carried at least to the nearest city, with no other items, and 1 / velocity is convex in weight,
+	// so time lost on that distance is lower bound of its cost in any solution
+	const double velocityDrop = (ttpConfig.maxVelocity - ttpConfig.minVelocity) / ttpConfig.capacityOfKnapsack;
+	const double velocity = ttpConfig.maxVelocity - item.weight * velocityDrop;
+	const double minCarryingDistance = ttpConfig.nearestDistanceLookup.at(item.cityId).second;
+	const double minTimeLoss = minCarryingDistance / velocity - minCarryingDistance / ttpConfig.maxVelocity;
+	return item.profit <= minTimeLoss;
+}
+
+std::vector<bool> InstancePreprocessor::findDominatedItems(const config::TtpConfig& ttpConfig) const
+{
+	// per city: sweep by weight ascending, item is dominated when lighter or equally heavy item has at least its profit
+	// and they are not identical
+	const auto& items = ttpConfig.items;
+	std::vector<uint32_t> order(items.size());
+	std::iota(order.begin(), order.end(), 0u);
+	std::sort(order.begin(), order.end(), [&items](const auto lhs, const auto rhs) {
+		if (items[lhs].cityId != items[rhs].cityId)
+			return items[lhs].cityId < items[rhs].cityId;
+		if (items[lhs].weight != items[rhs].weight)
+			return items[lhs].weight < items[rhs].weight;
+		return items[lhs].profit > items[rhs].profit;
+	});
+
+	std::vector<bool> dominated(items.size(), false);
+	auto groupBegin = order.cbegin();
+	uint32_t lighterItemsMaxProfit = 0u;
+	bool anyLighterItem = false;
+	while (groupBegin != order.cend())
+	{
+		const auto& first = items[*groupBegin];
+		auto groupEnd = std::find_if(groupBegin, order.cend(), [&items, &first](const auto index) {
+			return items[index].cityId != first.cityId || items[index].weight != first.weight; });
+		// group of the same city and weight, first one has the highest profit
+		for (auto it = groupBegin; it != groupEnd; ++it)
+			dominated[*it] = (anyLighterItem && lighterItemsMaxProfit >= items[*it].profit) || items[*it].profit < first.profit;
+		if (groupEnd != order.cend() && items[*groupEnd].cityId == first.cityId)
+		{
+			lighterItemsMaxProfit = anyLighterItem ? std::max(lighterItemsMaxProfit, first.profit) : first.profit;
+			anyLighterItem = true;
+		}
+		else
+		{
+			lighterItemsMaxProfit = 0u;
+			anyLighterItem = false;
+		}
+		groupBegin = groupEnd;
+	}
+	return dominated;
+}
+
+void InstancePreprocessor::renumberCitiesAlongHilbertCurve(config::TtpConfig& ttpConfig) const
+{
+	auto& cities = ttpConfig.cities;
+	if (cities.size() < 2)
+		return;
+	const auto curveOrder = utils::geo::orderAlongHilbertCurve(cities);
+
+	const auto citiesNum = static_cast<uint32_t>(cities.size());
+	std::vector<uint32_t> newIdOf(citiesNum + 1, 0u);
+	std::vector<uint32_t> originalIds(citiesNum + 1, 0u);
+	std::vector<ttp::City> renumbered;
+	renumbered.reserve(citiesNum);
+	for (auto newId = 1u; newId <= citiesNum; newId++)
+	{
+		const auto oldId = curveOrder[newId - 1];
+		newIdOf[oldId] = newId;
+		originalIds[newId] = ttpConfig.getOriginalCityId(oldId);
+		renumbered.push_back(cities[oldId - 1]);
+		renumbered.back().index = newId;
+	}
+	cities = std::move(renumbered);
+	ttpConfig.originalCityIds = std::move(originalIds);
+	for (auto& item : ttpConfig.items)
+		item.cityId = newIdOf[item.cityId];
+	std::unordered_map<uint32_t, std::pair<uint32_t, double>> nearestDistanceLookup;
+	nearestDistanceLookup.reserve(ttpConfig.nearestDistanceLookup.size());
+	for (const auto& [oldId, nearest] : ttpConfig.nearestDistanceLookup)
+		nearestDistanceLookup[newIdOf[oldId]] = std::make_pair(newIdOf[nearest.first], nearest.second);
+	ttpConfig.nearestDistanceLookup = std::move(nearestDistanceLookup);
+}
+
+} // namespace loader
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include <configuration/TtpConfig.hpp>
+
+namespace loader {
+
+struct PreprocessingOptions
+{
+	bool pruneUnprofitableItems;  // exact, removed items can't improve any solution
+	bool pruneDominatedItems;  // heuristic, removes items with other item in the same city both lighter and more profitable
+	bool renumberCitiesAlongHilbertCurve;  // spatially close cities get close ids, original ids are kept for output
+};
+
+struct PreprocessingReport
+{
+	std::string getStringRepresentation() const;
+
+	uint32_t itemsBefore;
+	uint32_t itemsAfter;
+	uint32_t overweightItemsRemoved;
+	uint32_t unprofitableItemsRemoved;
+	uint32_t dominatedItemsRemoved;
+	uint32_t citiesWithoutItems;
+	bool citiesRenumbered;
+};
+
+class InstancePreprocessor
+{
+public:
+	explicit InstancePreprocessor(const PreprocessingOptions& options);
+
+	// requires filled nearestDistanceLookup
+	PreprocessingReport preprocess(config::TtpConfig& ttpConfig) const;
+
+private:
+	bool isOverweight(const ttp::Item& item, const config::TtpConfig& ttpConfig) const;
+	bool isUnprofitable(const ttp::Item& item, const config::TtpConfig& ttpConfig) const;
+	std::vector<bool> findDominatedItems(const config::TtpConfig& ttpConfig) const;
+	void renumberCitiesAlongHilbertCurve(config::TtpConfig& ttpConfig) const;
+
+	const PreprocessingOptions options;
+};
+
+} // namespace loader
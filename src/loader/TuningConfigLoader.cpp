@@ -0,0 +1,106 @@
+#include "TuningConfigLoader.hpp"
+
+#include <chrono>
+#include <fstream>
+
+#include "ConfigParsingException.hpp"
+#include <utils/StringUtils.hpp>
+
+namespace loader {
+
+config::TuningConfig TuningConfigLoader::loadTuningConfig(const std::string& filePath) const
+{
+	std::ifstream fileHandle(filePath);
+	if (!fileHandle.is_open())
+		throw std::runtime_error("Could not read file: " + filePath);
+
+	config::TuningConfig tuningConfig;
+	std::string line;
+	while (std::getline(fileHandle, line))
+	{
+		decideWhatToDoWithLine(line, tuningConfig);
+	}
+
+	if (tuningConfig.instanceFilePaths.empty())
+		throw ConfigParsingException("No tuning instances given");
+	return tuningConfig;
+}
+
+void TuningConfigLoader::decideWhatToDoWithLine(const std::string& line, config::TuningConfig& tuningConfig) const
+{
+	if (line.find("TUNING INSTANCES:") != std::string::npos)
+	{
+		tuningConfig.instanceFilePaths = utils::str::split(prepareValueToStore(line));
+	}
+	else if (line.find("POPULATION SIZES:") != std::string::npos)
+	{
+		for (const auto& value : utils::str::split(prepareValueToStore(line)))
+			tuningConfig.populationSizes.push_back(std::stoi(value));
+	}
+	else if (line.find("TOURNAMENT SIZES:") != std::string::npos)
+	{
+		for (const auto& value : utils::str::split(prepareValueToStore(line)))
+			tuningConfig.tournamentSizes.push_back(std::stoi(value));
+	}
+	else if (line.find("CROSSOVER PROBABILITIES:") != std::string::npos)
+	{
+		for (const auto& value : utils::str::split(prepareValueToStore(line)))
+			tuningConfig.crossoverProbs.push_back(std::stod(value));
+	}
+	else if (line.find("MUTATION PROBABILITIES:") != std::string::npos)
+	{
+		for (const auto& value : utils::str::split(prepareValueToStore(line)))
+			tuningConfig.mutationProbs.push_back(std::stod(value));
+	}
+	else if (line.find("CROSSOVER TYPES:") != std::string::npos)
+	{
+		tuningConfig.crossoverTypes = utils::str::split(prepareValueToStore(line));
+	}
+	else if (line.find("RUN MAX GENERATIONS NUM:") != std::string::npos)
+	{
+		auto value = prepareValueToStore(line);
+		tuningConfig.runMaxPopulationsNum = std::stoi(value);
+	}
+	else if (line.find("RUN MAX ALG SECONDS DURATION:") != std::string::npos)
+	{
+		auto value = prepareValueToStore(line);
+		tuningConfig.runMaxGAlgDuration = std::chrono::seconds(std::stoi(value));
+	}
+	else if (line.find("MAX ROUNDS:") != std::string::npos)
+	{
+		auto value = prepareValueToStore(line);
+		tuningConfig.maxRounds = std::stoi(value);
+	}
+	else if (line.find("FIRST ELIMINATION ROUND:") != std::string::npos)
+	{
+		auto value = prepareValueToStore(line);
+		tuningConfig.firstEliminationRound = std::stoi(value);
+	}
+	else if (line.find("SIGNIFICANCE LEVEL:") != std::string::npos)
+	{
+		auto value = prepareValueToStore(line);
+		tuningConfig.significanceLevel = std::stod(value);
+	}
+	else if (line.find("THREADS:") != std::string::npos)
+	{
+		auto value = prepareValueToStore(line);
+		tuningConfig.threadsNum = std::stoi(value);
+	}
+	else if (line.find("RESULTS CSV FILE:") != std::string::npos)
+	{
+		auto value = prepareValueToStore(line);
+		tuningConfig.resultsCsvFile = value;
+	}
+}
+
+std::string TuningConfigLoader::prepareValueToStore(const std::string & s) const
+{
+	auto pos = s.find(':');
+	if (pos == std::string::npos)
+		throw ConfigParsingException("Bad file structure at line: \"" + s + "\"");
+	auto value = s.substr(pos + 1, s.length() - pos - 1);
+	utils::str::trim(value);
+	return value;
+}
+
+} // namespace loader
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <configuration/TuningConfig.hpp>
+
+
+namespace loader {
+
+class TuningConfigLoader
+{
+public:
+	config::TuningConfig loadTuningConfig(const std::string& filePath) const;
+
+private:
+	void decideWhatToDoWithLine(const std::string& line, config::TuningConfig& tuningConfig) const;
+	std::string prepareValueToStore(const std::string& s) const;
+};
+} // namespace loader
@@ -1,26 +1,323 @@
 #include <iostream>
-#include <random>
 #include <chrono>
+#include <cstdlib>
+#include <string>
 
 #include <loader/InstanceLoader.hpp>
+#include <loader/BenchmarkConfigLoader.hpp>
 #include <loader/GAlgConfigLoader.hpp>
+#include <loader/TuningConfigLoader.hpp>
 #include <loader/ConfigParsingException.hpp>
 #include <ttp/TtpIndividual.hpp>
 #include <ttp/Knapsack.hpp>
+#include <ttp/EvaluationPrecisionValidator.hpp>
 #include <ga/GAlg.hpp>
+#include <ga/AsyncGAlg.hpp>
+#include <ga/MemoryBudget.hpp>
+#include <aco/MaxMinAntSystem.hpp>
+#include <benchmark/AnytimeBenchmark.hpp>
+#include <benchmark/TourStructureBenchmark.hpp>
+#include <decomposition/DecompositionSolver.hpp>
 #include <logger/Logger.hpp>
 #include <naive/GreedyAlg.hpp>
 #include <naive/RandomSelectionAlg.hpp>
+#include <sa/ParallelTemperingSA.hpp>
+#include <server/SolverServer.hpp>
+#include <tuning/ParameterRace.hpp>
+#include <utils/Affinity.hpp>
+#include <utils/RandomUtils.hpp>
 
 using namespace std::chrono_literals;
 
+namespace {
+
+using IndividualPtr = std::unique_ptr<ttp::TtpIndividual>;
+
+template <class Alg>
+IndividualPtr runAlg(const config::GAlgParams& params, std::function<IndividualPtr(void)> createRandomFun, logging::Logger& logger)
+{
+	Alg alg(params, std::move(createRandomFun), logger);
+	alg.run();
+	return alg.getBestIndividual();
+}
+
+IndividualPtr runConfiguredAlg(const config::GAlgConfig& gAlgConfig, const config::TtpConfig& ttpConfig,
+	std::function<IndividualPtr(void)> createRandomFun, logging::Logger& logger)
+{
+	if (gAlgConfig.algorithm == "ga")
+		return runAlg<ga::GAlg<ttp::TtpIndividual>>(gAlgConfig.gAlgParams, std::move(createRandomFun), logger);
+	if (gAlgConfig.algorithm == "async_ga")
+		return runAlg<ga::AsyncGAlg<ttp::TtpIndividual>>(gAlgConfig.gAlgParams, std::move(createRandomFun), logger);
+	if (gAlgConfig.algorithm == "pt_sa")
+	{
+		sa::ParallelTemperingSA alg(gAlgConfig.gAlgParams, gAlgConfig.saParams, ttpConfig, std::move(createRandomFun), logger);
+		alg.run();
+		return alg.getBestIndividual();
+	}
+	if (gAlgConfig.algorithm == "mmas")
+	{
+		aco::MaxMinAntSystem alg(gAlgConfig.gAlgParams, gAlgConfig.acoParams, ttpConfig, logger);
+		alg.run();
+		return alg.getBestIndividual();
+	}
+	if (gAlgConfig.algorithm == "decomposition")
+	{
+		decomposition::DecompositionSolver alg(gAlgConfig.gAlgParams, gAlgConfig.decompositionParams, ttpConfig, logger);
+		alg.run();
+		return alg.getBestIndividual();
+	}
+	throw std::runtime_error("Unknown algorithm: " + gAlgConfig.algorithm);
+}
+
+config::EvaluationPrecision parseEvaluationPrecision(const std::string& name)
+{
+	if (name == "double")
+		return config::EvaluationPrecision::doublePrecision;
+	if (name == "float")
+		return config::EvaluationPrecision::singlePrecision;
+	throw std::runtime_error("Unknown evaluation precision: " + name);
+}
+
+utils::affinity::PinningPolicy parsePinningPolicy(const std::string& name)
+{
+	if (name == "none")
+		return utils::affinity::PinningPolicy::none;
+	if (name == "compact")
+		return utils::affinity::PinningPolicy::compact;
+	if (name == "scatter")
+		return utils::affinity::PinningPolicy::scatter;
+	throw std::runtime_error("Unknown thread pinning policy: " + name);
+}
+
+// before any instance is loaded and any worker started, so their memory is touched on chosen nodes first
+void applyAffinitySettings(const config::GAlgConfig& gAlgConfig, const uint32_t runNumber)
+{
+	if (gAlgConfig.numaNode == -2)
+		utils::affinity::pinProcessToNode(runNumber % static_cast<uint32_t>(utils::affinity::getTopology().cpusPerNode.size()));
+	else if (gAlgConfig.numaNode >= 0)
+		utils::affinity::pinProcessToNode(static_cast<uint32_t>(gAlgConfig.numaNode));
+	utils::affinity::setPinningPolicy(parsePinningPolicy(gAlgConfig.threadPinning));
+	utils::affinity::setHugePagesEnabled(gAlgConfig.hugePages);
+	utils::affinity::pinCurrentThread(0u);
+	std::cout << "topology: " << utils::affinity::getTopology().getStringRepresentation() << "; thread pinning: "
+		<< gAlgConfig.threadPinning << "; huge pages: " << (gAlgConfig.hugePages ? "on" : "off")
+		<< " (system mode: " << utils::affinity::getHugePagesMode() << ")" << std::endl;
+}
+
+void adviseHugePages(const config::TtpConfig& ttpConfig)
+{
+	utils::affinity::adviseHugePages(ttpConfig.cities.data(), ttpConfig.cities.size() * sizeof(ttp::City));
+	utils::affinity::adviseHugePages(ttpConfig.items.data(), ttpConfig.items.size() * sizeof(ttp::Item));
+	utils::affinity::adviseHugePages(ttpConfig.rankedItemsPerCity.data(), ttpConfig.rankedItemsPerCity.size() * sizeof(config::RankedItem));
+}
+
+// reports peak footprint of the run and caps population size to fit MEMORY BUDGET; individual is measured on
+// greedily packed tour in instance order, so no random numbers are drawn
+config::GAlgConfig applyMemoryBudget(const config::GAlgConfig& gAlgConfig, const config::TtpConfig& ttpConfig)
+{
+	auto budgetedConfig = gAlgConfig;
+	if (!ga::isMemoryBudgetSupported(gAlgConfig.algorithm))
+	{
+		if (gAlgConfig.memoryBudgetMb != 0u)
+			std::cout << "memory budget isn't applied to " << gAlgConfig.algorithm << std::endl;
+		return budgetedConfig;
+	}
+	ttp::TtpIndividual sample(ttpConfig, ttp::TspSolution(ttpConfig, std::vector<ttp::City>(ttpConfig.cities)));
+	sample.evaluate();
+	const auto instanceBytes = ttpConfig.getMemoryFootprint();
+	const auto individualBytes = sample.getMemoryFootprint();
+	auto& params = budgetedConfig.gAlgParams;
+	if (gAlgConfig.memoryBudgetMb != 0u)
+	{
+		params.populationSize = ga::fitPopulationSize(gAlgConfig.algorithm, params, instanceBytes, individualBytes,
+			gAlgConfig.memoryBudgetMb << 20);
+		if (params.populationSize != gAlgConfig.gAlgParams.populationSize)
+		{
+			std::cout << "memory budget: population size " << gAlgConfig.gAlgParams.populationSize << " -> "
+				<< params.populationSize << std::endl;
+		}
+	}
+	std::cout << "memory: " << ga::estimateFootprint(gAlgConfig.algorithm, params, instanceBytes, individualBytes).getStringRepresentation()
+		<< std::endl;
+	return budgetedConfig;
+}
+
+// usage: ttp_ga --validate-precision <instance path>...
+void validatePrecision(int argc, char **argv)
+{
+	constexpr uint32_t individualsNum = 1000u;
+	loader::InstanceLoader instanceLoader;
+	ttp::EvaluationPrecisionValidator validator(individualsNum);
+	for (auto i = 2; i < argc; i++)
+	{
+		auto ttpConfigBase = instanceLoader.loadTtpConfig(argv[i]);
+		std::cout << argv[i] << ": " << validator.validate(ttpConfigBase.getConfig()).getStringRepresentation() << std::endl;
+	}
+}
+
+// usage: ttp_ga --serve <socket path>, GA defaults and preprocessing options are read from gaConfig.txt
+void serve(const std::string& socketPath)
+{
+	loader::GAlgConfigLoader gAlgConfigLoader;
+	auto gAlgConfigBase = gAlgConfigLoader.loadGAlgConfig("gaConfig.txt");
+	const auto& gAlgConfig = gAlgConfigBase.getConfig();
+	if (gAlgConfig.randomSeed != 0u)
+		utils::rnd::Random::setGlobalSeed(gAlgConfig.randomSeed);
+	applyAffinitySettings(gAlgConfig, 0u);
+	server::SolverServer solverServer(gAlgConfig, parseEvaluationPrecision(gAlgConfig.evaluationPrecision), socketPath);
+	std::cout << "serving on " << socketPath << ", random seed: " << utils::rnd::Random::getGlobalSeed() << std::endl;
+	solverServer.run();
+}
+
+// preprocessed and set up as in a single run configured by gaConfig
+std::vector<config::TtpConfig> loadInstances(const std::vector<std::string>& instanceFilePaths, const config::GAlgConfig& gAlgConfig)
+{
+	loader::InstanceLoader instanceLoader;
+	loader::InstancePreprocessor preprocessor(
+		{ gAlgConfig.pruneUnprofitableItems, gAlgConfig.pruneDominatedItems, gAlgConfig.renumberCities });
+	std::vector<config::TtpConfig> instances;
+	for (const auto& instanceFilePath : instanceFilePaths)
+	{
+		loader::PreprocessingReport preprocessingReport;
+		instances.push_back(instanceLoader.loadTtpConfig(instanceFilePath, preprocessor, preprocessingReport).getConfig());
+		instances.back().evaluationPrecision = parseEvaluationPrecision(gAlgConfig.evaluationPrecision);
+		adviseHugePages(instances.back());
+	}
+	return instances;
+}
+
+// usage: ttp_ga --tune [tuning config path], base GA parameters and preprocessing options are read from gaConfig.txt
+void tune(const std::string& tuningConfigPath)
+{
+	loader::GAlgConfigLoader gAlgConfigLoader;
+	auto gAlgConfigBase = gAlgConfigLoader.loadGAlgConfig("gaConfig.txt");
+	const auto& gAlgConfig = gAlgConfigBase.getConfig();
+	loader::TuningConfigLoader tuningConfigLoader;
+	const auto tuningConfig = tuningConfigLoader.loadTuningConfig(tuningConfigPath);
+	if (gAlgConfig.randomSeed != 0u)
+		utils::rnd::Random::setGlobalSeed(gAlgConfig.randomSeed);
+	std::cout << "random seed: " << utils::rnd::Random::getGlobalSeed() << std::endl;
+	applyAffinitySettings(gAlgConfig, 0u);
+
+	const auto instances = loadInstances(tuningConfig.instanceFilePaths, gAlgConfig);
+	logging::Logger logger(tuningConfig.resultsCsvFile);
+	tuning::ParameterRace race(tuningConfig, gAlgConfig.gAlgParams, instances, logger);
+	race.run();
+	const auto best = race.getRanking().front();
+	std::cout << "best: population size " << best.params.populationSize << ", tournament size " << best.params.tournamentSize
+		<< ", crossover prob " << best.params.crossoverProb << ", mutation prob " << best.params.mutationProb
+		<< ", crossover type " << best.params.crossoverType << std::endl;
+}
+
+// usage: ttp_ga --benchmark [benchmark config path], GA parameters and naive repetitions are read from gaConfig.txt
+void runBenchmark(const std::string& benchmarkConfigPath)
+{
+	loader::GAlgConfigLoader gAlgConfigLoader;
+	auto gAlgConfigBase = gAlgConfigLoader.loadGAlgConfig("gaConfig.txt");
+	const auto& gAlgConfig = gAlgConfigBase.getConfig();
+	loader::BenchmarkConfigLoader benchmarkConfigLoader;
+	const auto benchmarkConfig = benchmarkConfigLoader.loadBenchmarkConfig(benchmarkConfigPath);
+	if (gAlgConfig.randomSeed != 0u)
+		utils::rnd::Random::setGlobalSeed(gAlgConfig.randomSeed);
+	std::cout << "random seed: " << utils::rnd::Random::getGlobalSeed() << std::endl;
+	applyAffinitySettings(gAlgConfig, 0u);
+	const auto instances = loadInstances(benchmarkConfig.instanceFilePaths, gAlgConfig);
+	benchmark::AnytimeBenchmark anytimeBenchmark(benchmarkConfig, gAlgConfig, instances);
+	anytimeBenchmark.run();
+}
+
+// usage: ttp_ga --benchmark-tour [cities num]..., prints ns per 2-opt move and per next / between query
+void benchmarkTourStructures(int argc, char **argv)
+{
+	constexpr uint32_t movesNum = 20000u;
+	std::vector<uint32_t> citiesNums{ 100u, 300u, 1000u, 3000u, 10000u, 30000u, 100000u };
+	if (argc >= 3)
+		citiesNums.clear();
+	for (auto i = 2; i < argc; i++)
+		citiesNums.push_back(std::stoul(argv[i]));
+	benchmark::TourStructureBenchmark tourStructureBenchmark(movesNum);
+	std::cout << "cities, array reversal ns, two-level reversal ns, array query ns, two-level query ns" << std::endl;
+	uint32_t crossoverCitiesNum = 0u;
+	for (const auto citiesNum : citiesNums)
+	{
+		const auto timings = tourStructureBenchmark.measure(citiesNum);
+		std::cout << timings.getStringRepresentation() << std::endl;
+		if (crossoverCitiesNum == 0u && timings.twoLevelReversalNs < timings.arrayReversalNs)
+			crossoverCitiesNum = citiesNum;
+	}
+	if (crossoverCitiesNum != 0u)
+		std::cout << "two-level tour reverses faster from " << crossoverCitiesNum << " cities" << std::endl;
+	else
+		std::cout << "array reverses faster on all measured sizes" << std::endl;
+}
+
+} // namespace
+
 int main(int argc, char **argv)
 {
+	if (argc >= 2 && std::string(argv[1]) == "--validate-precision")
+	{
+		try
+		{
+			validatePrecision(argc, argv);
+		}
+		catch (std::exception& e)
+		{
+			std::cout << "unknown error: " + std::string(e.what()) << std::endl;
+		}
+		return 0;
+	}
+	if (argc >= 3 && std::string(argv[1]) == "--serve")
+	{
+		try
+		{
+			serve(argv[2]);
+		}
+		catch (std::exception& e)
+		{
+			std::cout << "unknown error: " + std::string(e.what()) << std::endl;
+		}
+		return 0;
+	}
+	if (argc >= 2 && std::string(argv[1]) == "--tune")
+	{
+		try
+		{
+			tune(argc >= 3 ? argv[2] : "tuningConfig.txt");
+		}
+		catch (std::exception& e)
+		{
+			std::cout << "unknown error: " + std::string(e.what()) << std::endl;
+		}
+		return 0;
+	}
+	if (argc >= 2 && std::string(argv[1]) == "--benchmark")
+	{
+		try
+		{
+			runBenchmark(argc >= 3 ? argv[2] : "benchmarkConfig.txt");
+		}
+		catch (std::exception& e)
+		{
+			std::cout << "unknown error: " + std::string(e.what()) << std::endl;
+		}
+		return 0;
+	}
+	if (argc >= 2 && std::string(argv[1]) == "--benchmark-tour")
+	{
+		try
+		{
+			benchmarkTourStructures(argc, argv);
+		}
+		catch (std::exception& e)
+		{
+			std::cout << "unknown error: " + std::string(e.what()) << std::endl;
+		}
+		return 0;
+	}
 	std::string suffix;
-	if (argc == 2)
+	if (argc >= 2)
 		suffix = std::string(argv[1]);
-	std::random_device rd;
-	std::mt19937 g(rd());
 	std::cout << "starting" << std::endl;
 	try
 	{
@@ -28,30 +325,43 @@ int main(int argc, char **argv)
 		loader::GAlgConfigLoader gAlgConfigLoader;
 		auto gAlgConfigBase = gAlgConfigLoader.loadGAlgConfig("gaConfig.txt");
 		const auto& gAlgConfig = gAlgConfigBase.getConfig();
-		auto ttpConfigBase = instanceLoader.loadTtpConfig(gAlgConfig.instanceFilePath);
+		auto seed = argc >= 3 ? std::stoull(argv[2]) : gAlgConfig.randomSeed;
+		if (seed != 0u)
+			utils::rnd::Random::setGlobalSeed(seed);
+		std::cout << "random seed: " << utils::rnd::Random::getGlobalSeed() << std::endl;
+		// numeric suffix is the run number, runs started side by side spread over nodes with NUMA NODE: auto
+		applyAffinitySettings(gAlgConfig, static_cast<uint32_t>(std::strtoul(suffix.c_str(), nullptr, 10)));
+		loader::InstancePreprocessor preprocessor(
+			{ gAlgConfig.pruneUnprofitableItems, gAlgConfig.pruneDominatedItems, gAlgConfig.renumberCities });
+		loader::PreprocessingReport preprocessingReport;
+		auto ttpConfigBase = instanceLoader.loadTtpConfig(gAlgConfig.instanceFilePath, preprocessor, preprocessingReport);
+		std::cout << "preprocessing: " << preprocessingReport.getStringRepresentation() << std::endl;
 		auto ttpConfig = ttpConfigBase.getConfig();
-		auto createRandomFun = [&ttpConfig, &g]() {return ttp::TtpIndividual::createRandom(ttpConfig, g); };
+		ttpConfig.evaluationPrecision = parseEvaluationPrecision(gAlgConfig.evaluationPrecision);
+		adviseHugePages(ttpConfig);
+		auto createRandomFun = [&ttpConfig]() {
+			return ttp::TtpIndividual::createRandom(ttpConfig, utils::rnd::Random::getInstance().getRndGen()); };
 		logging::Logger logger(gAlgConfig.resultsCsvFile + suffix);
-		ga::GAlg<ttp::TtpIndividual> gAlg(gAlgConfig.gAlgParams, createRandomFun, logger);
-
-		gAlg.run();
+		const auto budgetedConfig = applyMemoryBudget(gAlgConfig, ttpConfig);
+		auto bestIndividual = runConfiguredAlg(budgetedConfig, ttpConfig, createRandomFun, logger);
 
 		logging::Logger logger2(gAlgConfig.bestIndividualResultFile + suffix);
 
-		auto bestIndividual = gAlg.getBestIndividual();
-
 		logger2.log("%s", bestIndividual->getStringRepresentation().c_str());
 
+		// baselines are quadratic in cities num, so they can be skipped for large instances
+		if (gAlgConfig.naiveRepetitions != 0)
+		{
+			logging::Logger logger3(gAlgConfig.bestGreedyAlgPath + suffix);
+			naive::GreedyAlg<ttp::TtpIndividual> greedyAlg(gAlgConfig.naiveRepetitions, ttpConfig);
+			auto bestFromGreedy = greedyAlg.executeAlg();
+			logger3.log("%s", bestFromGreedy->getStringRepresentation().c_str());
 
-		logging::Logger logger3(gAlgConfig.bestGreedyAlgPath + suffix);
-		naive::GreedyAlg<ttp::TtpIndividual> greedyAlg(gAlgConfig.naiveRepetitions, ttpConfig);
-		auto bestFromGreedy = greedyAlg.executeAlg();
-		logger3.log("%s", bestFromGreedy->getStringRepresentation().c_str());
-
-		logging::Logger logger4(gAlgConfig.bestRandomAlgPath + suffix);
-		naive::RandomSelectionAlg<ttp::TtpIndividual> rndAlg(gAlgConfig.naiveRepetitions, createRandomFun);
-		auto bestFromRandom = rndAlg.executeAlg();
-		logger4.log("%s", bestFromRandom->getStringRepresentation().c_str());
+			logging::Logger logger4(gAlgConfig.bestRandomAlgPath + suffix);
+			naive::RandomSelectionAlg<ttp::TtpIndividual> rndAlg(gAlgConfig.naiveRepetitions, createRandomFun);
+			auto bestFromRandom = rndAlg.executeAlg();
+			logger4.log("%s", bestFromRandom->getStringRepresentation().c_str());
+		}
 	}
 	catch (loader::ConfigParsingException& e)
 	{
@@ -0,0 +1,307 @@
+#include "AnnealingState.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace sa {
+
+namespace {
+
+struct SegmentScratch
+{
+	std::vector<uint32_t> weights;
+	std::vector<double> distances;
+	std::vector<double> times;
+};
+
+SegmentScratch& getSegmentScratch()
+{
+	thread_local SegmentScratch scratch;
+	return scratch;
+}
+
+uint32_t drawIndex(utils::rnd::RandomEngine& gen, const uint32_t range)  // [0, range)
+{
+	return static_cast<uint32_t>(((gen() >> 32) * range) >> 32);
+}
+
+double drawUnitDouble(utils::rnd::RandomEngine& gen)  // [0, 1)
+{
+	return static_cast<double>(gen() >> 11) * 0x1.0p-53;
+}
+
+} // namespace
+
+AnnealingState::AnnealingState(const config::TtpConfig& ttpConfig, const ttp::TtpIndividual& individual)
+	: ttpConfig(&ttpConfig)
+	, velocityDropPerWeightUnit((ttpConfig.maxVelocity - ttpConfig.minVelocity) / ttpConfig.capacityOfKnapsack)
+	, positionOfCity(ttpConfig.cities.size() + 1, 0u)
+	, weightOfCity(ttpConfig.cities.size() + 1, 0u)
+	, picked(ttpConfig.items.size(), 0u)
+	, totalWeight(0u)
+	, totalProfit(0.0)
+	, tripTime(0.0)
+	, bestFitness(-std::numeric_limits<double>::infinity())
+{
+	const auto& cityChain = individual.getCityChain();
+	tour.reserve(cityChain.size());
+	for (const auto& city : cityChain)
+		tour.push_back(city.index);
+
+	uint32_t maxItemIndex = 0u;
+	for (const auto& item : ttpConfig.items)
+		maxItemIndex = std::max(maxItemIndex, item.index);
+	std::vector<uint32_t> itemPosByIndex(maxItemIndex + 1, 0u);
+	for (auto i = 0u; i < ttpConfig.items.size(); i++)
+		itemPosByIndex[ttpConfig.items[i].index] = i;
+	for (const auto& item : individual.getKnapsack().getItems())
+	{
+		picked[itemPosByIndex[item.index]] = 1u;
+		weightOfCity[item.cityId] += item.weight;
+		totalWeight += item.weight;
+		totalProfit += item.profit;
+	}
+	recomputeLegs();
+	saveBest();
+}
+
+double AnnealingState::getFitness() const
+{
+	return totalProfit - tripTime;
+}
+
+double AnnealingState::getBestFitness() const
+{
+	return bestFitness;
+}
+
+void AnnealingState::sweep(const uint32_t movesNum, const double temperature, utils::rnd::RandomEngine& gen)
+{
+	auto accept = [temperature, &gen](const double delta) {
+		return delta >= 0.0 || drawUnitDouble(gen) < std::exp(delta / temperature); };
+	for (auto move = 0u; move < movesNum; move++)
+		tryRandomMove(gen, accept);
+	recomputeLegs();
+	if (getFitness() > bestFitness)
+		saveBest();
+}
+
+double AnnealingState::sampleWorseningDelta(const uint32_t movesNum, utils::rnd::RandomEngine& gen)
+{
+	double worseningSum = 0.0;
+	uint32_t worseningNum = 0u;
+	auto reject = [&worseningSum, &worseningNum](const double delta) {
+		if (delta < 0.0)
+		{
+			worseningSum -= delta;
+			worseningNum++;
+		}
+		return false;
+	};
+	for (auto move = 0u; move < movesNum; move++)
+		tryRandomMove(gen, reject);
+	return worseningNum > 0 ? worseningSum / worseningNum : 0.0;
+}
+
+std::unique_ptr<ttp::TtpIndividual> AnnealingState::createBestIndividual() const
+{
+	std::vector<ttp::City> cityChain;
+	cityChain.reserve(bestTour.size());
+	for (const auto cityId : bestTour)
+		cityChain.push_back(ttpConfig->cities[cityId - 1]);
+	ttp::Knapsack knapsack(ttpConfig->capacityOfKnapsack, static_cast<uint32_t>(ttpConfig->cities.size()));
+	for (auto i = 0u; i < bestPicked.size(); i++)
+	{
+		if (bestPicked[i])
+			knapsack.addItem(ttpConfig->items[i]);
+	}
+	auto individual = std::make_unique<ttp::TtpIndividual>(*ttpConfig,
+		ttp::TspSolution(*ttpConfig, std::move(cityChain)), std::move(knapsack));
+	individual->evaluate();
+	return individual;
+}
+
+template <class AcceptFun>
+void AnnealingState::tryRandomMove(utils::rnd::RandomEngine& gen, AcceptFun&& accept)
+{
+	// 40% 2-opt, 20% swap, 40% item flip
+	const auto citiesNum = static_cast<uint32_t>(tour.size());
+	const auto moveType = drawIndex(gen, 10u);
+	if (moveType >= 6u && !picked.empty())
+	{
+		tryItemFlip(drawIndex(gen, static_cast<uint32_t>(picked.size())), accept);
+		return;
+	}
+	if (citiesNum < 3)
+		return;
+	auto first = drawIndex(gen, citiesNum);
+	auto second = drawIndex(gen, citiesNum - 1);
+	if (second >= first)
+		second++;
+	if (first > second)
+		std::swap(first, second);
+	if (moveType < 4u)
+		tryReversal(first, second, accept);
+	else
+		trySwap(first, second, accept);
+}
+
+template <class AcceptFun>
+void AnnealingState::tryReversal(const uint32_t first, const uint32_t last, AcceptFun&& accept)
+{
+	std::reverse(tour.begin() + first, tour.begin() + last + 1);
+	const double delta = evaluateTourSegment(first, last);
+	if (accept(delta))
+	{
+		commitTourSegment(first, last);
+		tripTime -= delta;
+	}
+	else
+		std::reverse(tour.begin() + first, tour.begin() + last + 1);
+}
+
+template <class AcceptFun>
+void AnnealingState::trySwap(const uint32_t first, const uint32_t second, AcceptFun&& accept)
+{
+	std::swap(tour[first], tour[second]);
+	const double delta = evaluateTourSegment(first, second);
+	if (accept(delta))
+	{
+		commitTourSegment(first, second);
+		tripTime -= delta;
+	}
+	else
+		std::swap(tour[first], tour[second]);
+}
+
+template <class AcceptFun>
+void AnnealingState::tryItemFlip(const uint32_t itemPos, AcceptFun&& accept)
+{
+	const auto& item = ttpConfig->items[itemPos];
+	if (!picked[itemPos] && totalWeight + item.weight > ttpConfig->capacityOfKnapsack)
+		return;
+	const int64_t weightChange = picked[itemPos] ? -static_cast<int64_t>(item.weight) : item.weight;
+	const double profitChange = picked[itemPos] ? -static_cast<double>(item.profit) : item.profit;
+	const auto citiesNum = static_cast<uint32_t>(tour.size());
+	const auto position = positionOfCity[item.cityId];
+	auto& scratch = getSegmentScratch();
+	scratch.times.resize(citiesNum - position);
+	double timeBefore = 0.0;
+	double timeAfter = 0.0;
+	for (auto k = position; k < citiesNum; k++)
+	{
+		const auto time = getLegTime(legDistance[k], static_cast<uint32_t>(legWeight[k] + weightChange));
+		scratch.times[k - position] = time;
+		timeBefore += legTime[k];
+		timeAfter += time;
+	}
+	const double delta = profitChange + timeBefore - timeAfter;
+	if (!accept(delta))
+		return;
+	for (auto k = position; k < citiesNum; k++)
+	{
+		legWeight[k] = static_cast<uint32_t>(legWeight[k] + weightChange);
+		legTime[k] = scratch.times[k - position];
+	}
+	picked[itemPos] ^= 1u;
+	weightOfCity[item.cityId] = static_cast<uint32_t>(weightOfCity[item.cityId] + weightChange);
+	totalWeight = static_cast<uint32_t>(totalWeight + weightChange);
+	totalProfit += profitChange;
+	tripTime += timeAfter - timeBefore;
+}
+
+double AnnealingState::evaluateTourSegment(const uint32_t first, const uint32_t last) const
+{
+	// weights of legs outside [first, last] don't change, as the same cities are visited before them
+	auto& scratch = getSegmentScratch();
+	scratch.weights.clear();
+	scratch.distances.clear();
+	scratch.times.clear();
+	const auto citiesNum = static_cast<uint32_t>(tour.size());
+	double timeBefore = 0.0;
+	double timeAfter = 0.0;
+	if (first != 0 || last != citiesNum - 1)
+	{
+		const auto previousLeg = first == 0 ? citiesNum - 1 : first - 1;
+		const auto distance = getDistance(tour[previousLeg], tour[first]);
+		const auto time = getLegTime(distance, legWeight[previousLeg]);
+		scratch.weights.push_back(legWeight[previousLeg]);
+		scratch.distances.push_back(distance);
+		scratch.times.push_back(time);
+		timeBefore += legTime[previousLeg];
+		timeAfter += time;
+	}
+	uint32_t weight = first == 0 ? 0u : legWeight[first - 1];
+	for (auto k = first; k <= last; k++)
+	{
+		weight += weightOfCity[tour[k]];
+		const auto distance = getDistance(tour[k], tour[k + 1 == citiesNum ? 0 : k + 1]);
+		const auto time = getLegTime(distance, weight);
+		scratch.weights.push_back(weight);
+		scratch.distances.push_back(distance);
+		scratch.times.push_back(time);
+		timeBefore += legTime[k];
+		timeAfter += time;
+	}
+	return timeBefore - timeAfter;
+}
+
+void AnnealingState::commitTourSegment(const uint32_t first, const uint32_t last)
+{
+	const auto& scratch = getSegmentScratch();
+	const auto citiesNum = static_cast<uint32_t>(tour.size());
+	auto scratchPos = 0u;
+	if (first != 0 || last != citiesNum - 1)
+	{
+		const auto previousLeg = first == 0 ? citiesNum - 1 : first - 1;
+		legDistance[previousLeg] = scratch.distances[scratchPos];
+		legTime[previousLeg] = scratch.times[scratchPos];
+		scratchPos++;
+	}
+	for (auto k = first; k <= last; k++, scratchPos++)
+	{
+		positionOfCity[tour[k]] = k;
+		legWeight[k] = scratch.weights[scratchPos];
+		legDistance[k] = scratch.distances[scratchPos];
+		legTime[k] = scratch.times[scratchPos];
+	}
+}
+
+double AnnealingState::getLegTime(const double distance, const uint32_t weight) const
+{
+	return distance / (ttpConfig->maxVelocity - weight * velocityDropPerWeightUnit);
+}
+
+double AnnealingState::getDistance(const uint32_t cityId1, const uint32_t cityId2) const
+{
+	return ttpConfig->cities[cityId1 - 1].getDistance(ttpConfig->cities[cityId2 - 1]);
+}
+
+void AnnealingState::recomputeLegs()
+{
+	const auto citiesNum = static_cast<uint32_t>(tour.size());
+	legWeight.resize(citiesNum);
+	legDistance.resize(citiesNum);
+	legTime.resize(citiesNum);
+	uint32_t weight = 0u;
+	tripTime = 0.0;
+	for (auto k = 0u; k < citiesNum; k++)
+	{
+		positionOfCity[tour[k]] = k;
+		weight += weightOfCity[tour[k]];
+		legWeight[k] = weight;
+		legDistance[k] = getDistance(tour[k], tour[k + 1 == citiesNum ? 0 : k + 1]);
+		legTime[k] = getLegTime(legDistance[k], weight);
+		tripTime += legTime[k];
+	}
+}
+
+void AnnealingState::saveBest()
+{
+	bestTour = tour;
+	bestPicked = picked;
+	bestFitness = getFitness();
+}
+
+} // namespace sa
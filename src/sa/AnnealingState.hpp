@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <configuration/TtpConfig.hpp>
+#include <ttp/TtpIndividual.hpp>
+#include <utils/RandomUtils.hpp>
+
+namespace sa {
+
+// TTP solution of a single annealing chain kept as flat arrays with weight, distance and time of every leg,
+// so moves are evaluated by recomputing only legs they change: 2-opt and swap of positions i < j touch legs
+// before i up to j, flipping item in city at position p touches legs from p to the end of tour.
+// Packing is part of the state, it is not refilled greedily after tour moves.
+// Tour stays an array even on big instances: weights of all legs of a reversed path change, so evaluating 2-opt
+// walks the whole path anyway and reversing it with TwoLevelTour wouldn't change the cost of a move.
+class AnnealingState
+{
+public:
+	AnnealingState(const config::TtpConfig& ttpConfig, const ttp::TtpIndividual& individual);
+
+	AnnealingState() = delete;
+	AnnealingState(const AnnealingState&) = default;
+	AnnealingState(AnnealingState&&) = default;
+	~AnnealingState() = default;
+
+	AnnealingState& operator=(const AnnealingState&) = default;
+	AnnealingState& operator=(AnnealingState&&) = default;
+
+	double getFitness() const;
+	double getBestFitness() const;
+	void sweep(const uint32_t movesNum, const double temperature, utils::rnd::RandomEngine& gen);
+	double sampleWorseningDelta(const uint32_t movesNum, utils::rnd::RandomEngine& gen);  // mean of worsening moves, state unchanged
+	std::unique_ptr<ttp::TtpIndividual> createBestIndividual() const;
+
+private:
+	template <class AcceptFun>
+	void tryRandomMove(utils::rnd::RandomEngine& gen, AcceptFun&& accept);
+	template <class AcceptFun>
+	void tryReversal(const uint32_t first, const uint32_t last, AcceptFun&& accept);
+	template <class AcceptFun>
+	void trySwap(const uint32_t first, const uint32_t second, AcceptFun&& accept);
+	template <class AcceptFun>
+	void tryItemFlip(const uint32_t itemPos, AcceptFun&& accept);
+	double evaluateTourSegment(const uint32_t first, const uint32_t last) const;  // fitness delta, tour already modified
+	void commitTourSegment(const uint32_t first, const uint32_t last);
+	double getLegTime(const double distance, const uint32_t weight) const;
+	double getDistance(const uint32_t cityId1, const uint32_t cityId2) const;
+	void recomputeLegs();  // drops rounding errors accumulated by deltas
+	void saveBest();
+
+	const config::TtpConfig* ttpConfig;  // pointer, so states can be exchanged between chains
+	double velocityDropPerWeightUnit;
+	std::vector<uint32_t> tour;  // city ids
+	std::vector<uint32_t> positionOfCity;  // indexed by city id
+	std::vector<uint32_t> weightOfCity;  // picked weight, indexed by city id
+	std::vector<uint8_t> picked;  // indexed like ttpConfig.items
+	// leg k goes from tour[k] to tour[k + 1], last one closes cycle
+	std::vector<uint32_t> legWeight;
+	std::vector<double> legDistance;
+	std::vector<double> legTime;
+	uint32_t totalWeight;
+	double totalProfit;
+	double tripTime;
+	std::vector<uint32_t> bestTour;
+	std::vector<uint8_t> bestPicked;
+	double bestFitness;
+};
+
+} // namespace sa
@@ -0,0 +1,126 @@
+#include "ParallelTemperingSA.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+
+#include <utils/Affinity.hpp>
+#include <utils/ThreadPool.hpp>
+
+namespace sa {
+
+ParallelTemperingSA::ParallelTemperingSA(const config::GAlgParams& params, const config::SaParams& saParams,
+	const config::TtpConfig& ttpConfig, std::function<IndividualPtr(void)> createRandomFun, logging::Logger& logger)
+	: params(params)
+	, saParams(saParams)
+	, ttpConfig(ttpConfig)
+	, createRandomFun(std::move(createRandomFun))
+	, threadsNum(params.threadsNum != 0 ? params.threadsNum : std::max(1u, std::thread::hardware_concurrency()))
+	, logger(logger)
+	, sweepsNum(0u)
+{
+	if (saParams.chainsNum == 0)
+		throw std::runtime_error("SA chains num can't be 0");
+	if (saParams.maxTemperature < 0.0 || saParams.minTemperature < 0.0)
+		throw std::runtime_error("SA temperatures can't be negative");
+}
+
+void ParallelTemperingSA::run()
+{
+	startTimestamp = SteadyClock::now();
+	initialize();
+	calibrateTemperatures();
+	logState();
+	while (!checkStopConditions())
+	{
+		sweepAll();
+		exchangeStates();
+		sweepsNum++;
+		logState();
+	}
+}
+
+ParallelTemperingSA::IndividualPtr ParallelTemperingSA::getBestIndividual() const
+{
+	auto bestIt = std::max_element(states.cbegin(), states.cend(),
+		[](const auto& lhs, const auto& rhs) {return lhs.getBestFitness() < rhs.getBestFitness(); });
+	return bestIt->createBestIndividual();
+}
+
+void ParallelTemperingSA::initialize()
+{
+	// chains start from greedily packed random tours
+	states.reserve(saParams.chainsNum);
+	gens.reserve(saParams.chainsNum);
+	for (auto chain = 0u; chain < saParams.chainsNum; chain++)
+	{
+		auto individual = createRandomFun();
+		individual->evaluate();
+		states.emplace_back(ttpConfig, *individual);
+		gens.emplace_back(utils::rnd::Random::getGlobalSeed(), chain + 1);  // stream 0 is used by calling thread
+	}
+}
+
+void ParallelTemperingSA::calibrateTemperatures()
+{
+	double maxTemperature = saParams.maxTemperature;
+	if (maxTemperature == 0.0)
+	{
+		// worsening move of average size accepted with probability 1/2 in the hottest chain
+		constexpr uint32_t calibrationMovesNum = 1000u;
+		auto calibrationGen = utils::rnd::RandomEngine(utils::rnd::Random::getGlobalSeed(), saParams.chainsNum + 1);
+		maxTemperature = states.front().sampleWorseningDelta(calibrationMovesNum, calibrationGen) / std::log(2.0);
+		if (maxTemperature == 0.0)
+			maxTemperature = 1.0;
+	}
+	const double minTemperature = saParams.minTemperature != 0.0 ? saParams.minTemperature : maxTemperature / 1000.0;
+	temperatures.resize(saParams.chainsNum);
+	for (auto chain = 0u; chain < saParams.chainsNum; chain++)
+	{
+		const double ladderPos = saParams.chainsNum > 1 ? static_cast<double>(chain) / (saParams.chainsNum - 1) : 0.0;
+		temperatures[chain] = minTemperature * std::pow(maxTemperature / minTemperature, ladderPos);
+	}
+}
+
+void ParallelTemperingSA::sweepAll()
+{
+	auto sweepChains = [this](const uint32_t firstChain, const uint32_t step) {
+		utils::affinity::pinCurrentThread(firstChain);
+		for (auto chain = firstChain; chain < states.size(); chain += step)
+			states[chain].sweep(saParams.movesPerExchange, temperatures[chain], gens[chain]);
+	};
+	utils::runWorkers(std::min(threadsNum, saParams.chainsNum), sweepChains);
+}
+
+void ParallelTemperingSA::exchangeStates()
+{
+	auto& random = utils::rnd::Random::getInstance();
+	for (auto chain = sweepsNum % 2; chain + 1 < states.size(); chain += 2)
+	{
+		const double logAcceptance = (states[chain + 1].getFitness() - states[chain].getFitness()) *
+			(1.0 / temperatures[chain] - 1.0 / temperatures[chain + 1]);
+		if (logAcceptance >= 0.0 || random.getRandomDouble(0.0, 1.0) < std::exp(logAcceptance))
+			std::swap(states[chain], states[chain + 1]);
+	}
+}
+
+bool ParallelTemperingSA::checkStopConditions() const
+{
+	if (params.maxPopulationsNum != 0 && sweepsNum >= params.maxPopulationsNum)
+		return true;
+	return params.maxGAlgDuration != std::chrono::seconds::zero() && SteadyClock::now() - startTimestamp >= params.maxGAlgDuration;
+}
+
+void ParallelTemperingSA::logState() const
+{
+	auto bestWorstIterators = std::minmax_element(states.cbegin(), states.cend(),
+		[](const auto& lhs, const auto& rhs) {return lhs.getFitness() < rhs.getFitness(); });
+	double sumOfFitnesses = 0.0;
+	for (const auto& state : states)
+		sumOfFitnesses += state.getFitness();
+	logger.log("%d, %.4f, %.4f, %.4f", sweepsNum, bestWorstIterators.second->getFitness(),
+		sumOfFitnesses / states.size(), bestWorstIterators.first->getFitness());
+}
+
+} // namespace sa
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "AnnealingState.hpp"
+#include <configuration/GAlgConfig.hpp>
+#include <configuration/TtpConfig.hpp>
+#include <logger/Logger.hpp>
+#include <ttp/TtpIndividual.hpp>
+#include <utils/RandomUtils.hpp>
+
+namespace sa {
+
+// Parallel tempering: chains at fixed, geometrically spaced temperatures run annealing sweeps in parallel,
+// after every sweep states of neighbouring chains are exchanged with Metropolis probability, even and odd pairs alternately.
+// Every chain has its own random stream and exchanges are drawn in calling thread, so results don't depend on threads num.
+// One "generation" in logs and stop conditions is one sweep of all chains.
+class ParallelTemperingSA
+{
+public:
+	using IndividualPtr = std::unique_ptr<ttp::TtpIndividual>;
+
+	ParallelTemperingSA(const config::GAlgParams& params, const config::SaParams& saParams, const config::TtpConfig& ttpConfig,
+		std::function<IndividualPtr(void)> createRandomFun, logging::Logger& logger);
+
+	ParallelTemperingSA() = delete;
+	ParallelTemperingSA(const ParallelTemperingSA&) = delete;
+	ParallelTemperingSA(ParallelTemperingSA&&) = delete;
+	~ParallelTemperingSA() = default;
+
+	ParallelTemperingSA& operator=(const ParallelTemperingSA&) = delete;
+	ParallelTemperingSA& operator=(ParallelTemperingSA&&) = delete;
+
+	void run();
+	IndividualPtr getBestIndividual() const;
+
+private:
+	using SteadyClock = std::chrono::steady_clock;
+
+	void initialize();
+	void calibrateTemperatures();
+	void sweepAll();
+	void exchangeStates();
+	bool checkStopConditions() const;
+	void logState() const;
+
+	const config::GAlgParams params;
+	const config::SaParams saParams;
+	const config::TtpConfig& ttpConfig;
+	std::function<IndividualPtr(void)> createRandomFun;
+	const uint32_t threadsNum;
+
+	std::vector<AnnealingState> states;  // states[k] is run at temperatures[k], coldest first
+	std::vector<double> temperatures;
+	std::vector<utils::rnd::RandomEngine> gens;  // stay with temperatures when states are exchanged
+
+	logging::Logger& logger;
+	uint32_t sweepsNum;
+	SteadyClock::time_point startTimestamp;
+};
+
+} // namespace sa
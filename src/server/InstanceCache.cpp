@@ -0,0 +1,58 @@
+#include "InstanceCache.hpp"
+
+namespace server {
+
+InstanceCache::InstanceCache(const loader::PreprocessingOptions& preprocessingOptions,
+	const config::EvaluationPrecision evaluationPrecision)
+	: instanceLoader()
+	, preprocessor(preprocessingOptions)
+	, evaluationPrecision(evaluationPrecision)
+{
+}
+
+InstanceCache::TtpConfigPtr InstanceCache::get(const std::string& instanceFilePath)
+{
+	std::promise<TtpConfigPtr> loading;
+	std::shared_future<TtpConfigPtr> loaded;
+	{
+		std::lock_guard<std::mutex> lock(instancesMutex);
+		const auto it = instances.find(instanceFilePath);
+		if (it != instances.end())
+			loaded = it->second;
+		else
+			instances.emplace(instanceFilePath, loading.get_future().share());
+	}
+	if (loaded.valid())
+		return loaded.get();  // rethrows when the loading request failed
+	try
+	{
+		auto ttpConfig = load(instanceFilePath);
+		loading.set_value(ttpConfig);
+		return ttpConfig;
+	}
+	catch (...)
+	{
+		// waiting requests get the same error, failed instance isn't cached so it can be retried
+		loading.set_exception(std::current_exception());
+		std::lock_guard<std::mutex> lock(instancesMutex);
+		instances.erase(instanceFilePath);
+		throw;
+	}
+}
+
+InstanceCache::TtpConfigPtr InstanceCache::load(const std::string& instanceFilePath) const
+{
+	loader::PreprocessingReport report;
+	auto ttpConfig = std::make_shared<config::TtpConfig>(
+		instanceLoader.loadTtpConfig(instanceFilePath, preprocessor, report).getConfig());
+	ttpConfig->evaluationPrecision = evaluationPrecision;
+	return ttpConfig;
+}
+
+size_t InstanceCache::getSize() const
+{
+	std::lock_guard<std::mutex> lock(instancesMutex);
+	return instances.size();
+}
+
+} // namespace server
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <configuration/TtpConfig.hpp>
+#include <loader/InstanceLoader.hpp>
+#include <loader/InstancePreprocessor.hpp>
+
+namespace server {
+
+// Instances loaded and preprocessed once, then shared read-only by all requests; safe to use from many threads
+class InstanceCache
+{
+public:
+	using TtpConfigPtr = std::shared_ptr<const config::TtpConfig>;
+
+	InstanceCache(const loader::PreprocessingOptions& preprocessingOptions, const config::EvaluationPrecision evaluationPrecision);
+
+	InstanceCache() = delete;
+	InstanceCache(const InstanceCache&) = delete;
+	InstanceCache(InstanceCache&&) = delete;
+	~InstanceCache() = default;
+
+	InstanceCache& operator=(const InstanceCache&) = delete;
+	InstanceCache& operator=(InstanceCache&&) = delete;
+
+	TtpConfigPtr get(const std::string& instanceFilePath);  // loads instance on first use
+	size_t getSize() const;  // includes instances still being loaded
+
+private:
+	TtpConfigPtr load(const std::string& instanceFilePath) const;
+
+	const loader::InstanceLoader instanceLoader;
+	const loader::InstancePreprocessor preprocessor;
+	const config::EvaluationPrecision evaluationPrecision;
+
+	// lock guards only the map, parsing is done by the first requester while later ones wait on its future
+	mutable std::mutex instancesMutex;
+	std::unordered_map<std::string, std::shared_future<TtpConfigPtr>> instances;
+};
+
+} // namespace server
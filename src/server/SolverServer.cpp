@@ -0,0 +1,322 @@
+#include "SolverServer.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#ifndef _WIN32
+#include <csignal>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#include <ga/GAlg.hpp>
+#include <logger/Logger.hpp>
+#include <ttp/TtpIndividual.hpp>
+#include <utils/RandomUtils.hpp>
+#include <utils/ThreadPool.hpp>
+
+namespace server {
+
+namespace {
+
+constexpr int pollTimeoutMs = 200;  // how quickly idle loops notice shutdown
+
+bool sendLine(const int fd, const std::string& line)
+{
+#ifndef _WIN32
+	const auto message = line + '\n';
+	size_t sent = 0u;
+	while (sent < message.size())
+	{
+		const auto result = ::write(fd, message.data() + sent, message.size() - sent);
+		if (result <= 0)
+			return false;
+		sent += static_cast<size_t>(result);
+	}
+	return true;
+#else
+	static_cast<void>(fd);
+	static_cast<void>(line);
+	return false;
+#endif
+}
+
+bool isClientGone(const int fd)
+{
+	// hang up is reported without consuming pending input, so commands sent ahead stay readable
+#ifndef _WIN32
+#ifdef POLLRDHUP
+	constexpr short hangUpEvents = POLLHUP | POLLERR | POLLNVAL | POLLRDHUP;  // POLLRDHUP: peer closed, Linux only
+#else
+	constexpr short hangUpEvents = POLLHUP | POLLERR | POLLNVAL;
+#endif
+	pollfd clientPoll{ fd, hangUpEvents, 0 };
+	return ::poll(&clientPoll, 1, 0) < 0 || (clientPoll.revents & hangUpEvents) != 0;
+#else
+	static_cast<void>(fd);
+	return false;
+#endif
+}
+
+std::string formatDouble(const char* format, const double value)
+{
+	char buffer[64];
+	std::snprintf(buffer, sizeof(buffer), format, value);
+	return buffer;
+}
+
+const std::string& getArgument(const std::map<std::string, std::string>& arguments, const std::string& key)
+{
+	const auto it = arguments.find(key);
+	if (it == arguments.end())
+		throw std::runtime_error("missing argument: " + key);
+	return it->second;
+}
+
+template <class T, class ParseFun>
+T parseArgument(const std::map<std::string, std::string>& arguments, const std::string& key, const T defaultValue, ParseFun parse)
+{
+	const auto it = arguments.find(key);
+	if (it == arguments.end())
+		return defaultValue;
+	try
+	{
+		return static_cast<T>(parse(it->second));
+	}
+	catch (std::exception&)
+	{
+		throw std::runtime_error("invalid value of " + key + ": " + it->second);
+	}
+}
+
+uint64_t parseUnsigned(const std::string& s)
+{
+	if (s.empty() || s[0] == '-')
+		throw std::invalid_argument(s);
+	return std::stoull(s);
+}
+
+double parseDouble(const std::string& s)
+{
+	return std::stod(s);
+}
+
+// TOUR and PACKING lines, with ids as in instance file
+bool sendSolution(const int fd, const ttp::TtpIndividual& individual, const config::TtpConfig& ttpConfig)
+{
+	std::string tour = "TOUR";
+	for (const auto& city : individual.getCityChain())
+		tour.append(" ").append(std::to_string(ttpConfig.getOriginalCityId(city.index)));
+	std::vector<uint32_t> itemIds;
+	for (const auto& item : individual.getKnapsack().getItems())
+		itemIds.push_back(item.index);
+	std::sort(itemIds.begin(), itemIds.end());
+	std::string packing = "PACKING";
+	for (const auto itemId : itemIds)
+		packing.append(" ").append(std::to_string(itemId));
+	return sendLine(fd, tour) && sendLine(fd, packing);
+}
+
+} // namespace
+
+SolverServer::SolverServer(const config::GAlgConfig& defaults, const config::EvaluationPrecision evaluationPrecision,
+	const std::string& socketPath)
+	: defaults(defaults)
+	, socketPath(socketPath)
+	, instanceCache({ defaults.pruneUnprofitableItems, defaults.pruneDominatedItems, defaults.renumberCities }, evaluationPrecision)
+	, shutdownRequested(false)
+	, requestsNum(0u)
+{
+}
+
+#ifndef _WIN32
+
+void SolverServer::run()
+{
+	sockaddr_un address{};
+	address.sun_family = AF_UNIX;
+	if (socketPath.empty() || socketPath.size() >= sizeof(address.sun_path))
+		throw std::runtime_error("Invalid socket path: " + socketPath);
+	std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+	std::signal(SIGPIPE, SIG_IGN);  // writes to disconnected clients fail instead of killing process
+	const int listenFd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+	if (listenFd < 0)
+		throw std::runtime_error("Could not create socket");
+	::unlink(socketPath.c_str());
+	if (::bind(listenFd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || ::listen(listenFd, SOMAXCONN) != 0)
+	{
+		::close(listenFd);
+		throw std::runtime_error("Could not listen on socket: " + socketPath);
+	}
+	{
+		utils::ThreadPool threadPool(defaults.gAlgParams.threadsNum);  // joined before socket is removed
+		while (!shutdownRequested)
+		{
+			pollfd listenPoll{ listenFd, POLLIN, 0 };
+			if (::poll(&listenPoll, 1, pollTimeoutMs) <= 0)
+				continue;
+			const int clientFd = ::accept(listenFd, nullptr, nullptr);
+			if (clientFd < 0)
+				continue;
+			threadPool.submit([this, clientFd]() {
+				serveClient(clientFd);
+				::close(clientFd);
+			});
+		}
+	}
+	::close(listenFd);
+	::unlink(socketPath.c_str());
+}
+
+void SolverServer::serveClient(const int clientFd)
+{
+	std::string pending;
+	char buffer[4096];
+	while (!shutdownRequested)
+	{
+		pollfd clientPoll{ clientFd, POLLIN, 0 };
+		const auto ready = ::poll(&clientPoll, 1, pollTimeoutMs);
+		if (ready < 0)
+			return;
+		if (ready == 0)
+			continue;
+		const auto received = ::read(clientFd, buffer, sizeof(buffer));
+		if (received <= 0)
+			return;
+		pending.append(buffer, static_cast<size_t>(received));
+		size_t lineEnd;
+		while ((lineEnd = pending.find('\n')) != std::string::npos)
+		{
+			auto line = pending.substr(0, lineEnd);
+			pending.erase(0, lineEnd + 1);
+			if (!line.empty() && line.back() == '\r')
+				line.pop_back();
+			handleCommand(clientFd, line);
+		}
+	}
+}
+
+#else
+
+void SolverServer::run()
+{
+	throw std::runtime_error("Solver server requires Unix domain sockets, not supported on this platform");
+}
+
+void SolverServer::serveClient(const int)
+{
+}
+
+#endif
+
+void SolverServer::handleCommand(const int clientFd, const std::string& line)
+{
+	std::istringstream lineStream(line);
+	std::string command;
+	lineStream >> command;
+	Arguments arguments;
+	std::string token;
+	while (lineStream >> token)
+	{
+		const auto separator = token.find('=');
+		if (separator == std::string::npos)
+		{
+			sendLine(clientFd, "ERROR argument not in key=value form: " + token);
+			return;
+		}
+		arguments[token.substr(0, separator)] = token.substr(separator + 1);
+	}
+
+	try
+	{
+		if (command.empty())
+			return;
+		else if (command == "PING")
+			sendLine(clientFd, "PONG");
+		else if (command == "LOAD")
+			load(clientFd, arguments);
+		else if (command == "SOLVE")
+			solve(clientFd, arguments);
+		else if (command == "SHUTDOWN")
+		{
+			shutdownRequested = true;
+			sendLine(clientFd, "BYE");
+		}
+		else
+			sendLine(clientFd, "ERROR unknown command: " + command);
+	}
+	catch (std::exception& e)
+	{
+		sendLine(clientFd, "ERROR " + std::string(e.what()));
+	}
+}
+
+void SolverServer::load(const int clientFd, const Arguments& arguments)
+{
+	const auto ttpConfig = instanceCache.get(getArgument(arguments, "instance"));
+	sendLine(clientFd, "LOADED " + std::to_string(ttpConfig->cities.size()) + " " + std::to_string(ttpConfig->items.size()));
+}
+
+void SolverServer::solve(const int clientFd, const Arguments& arguments)
+{
+	using SteadyClock = std::chrono::steady_clock;
+
+	const auto params = makeParams(arguments);
+	const auto ttpConfig = instanceCache.get(getArgument(arguments, "instance"));
+	const auto requestId = ++requestsNum;
+	utils::rnd::Random::getInstance().useStream(
+		parseArgument<uint64_t>(arguments, "stream", requestId, parseUnsigned));
+	const bool streamSolutions = parseArgument<uint64_t>(arguments, "improved_solutions", 0u, parseUnsigned) != 0;
+	const bool logGenerations = parseArgument<uint64_t>(arguments, "log", 0u, parseUnsigned) != 0;
+
+	auto createRandomFun = [&ttpConfig]() {
+		return ttp::TtpIndividual::createRandom(*ttpConfig, utils::rnd::Random::getInstance().getRndGen()); };
+	logging::Logger logger(logGenerations ? defaults.resultsCsvFile + "_request" + std::to_string(requestId) : "");
+	ga::GAlg<ttp::TtpIndividual> gAlg(params, createRandomFun, logger);
+	const auto startTimestamp = SteadyClock::now();
+	gAlg.setImprovementCallback([clientFd, startTimestamp, streamSolutions, &ttpConfig, &gAlg](
+		const ttp::TtpIndividual& best, const uint32_t populationsNum) {
+		const auto elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(SteadyClock::now() - startTimestamp).count();
+		const bool isSent = sendLine(clientFd, "IMPROVED " + std::to_string(populationsNum) + " " + std::to_string(elapsedMs) + " " +
+			formatDouble("%.4f", best.getCurrentFitness())) && (!streamSolutions || sendSolution(clientFd, best, *ttpConfig));
+		if (!isSent)
+			gAlg.requestStop();  // client went away
+	});
+	gAlg.setStopPredicate([clientFd]() {return isClientGone(clientFd); });
+	if (!sendLine(clientFd, "ACCEPTED " + std::to_string(requestId)))
+		return;
+	gAlg.run();
+
+	const auto best = gAlg.getBestIndividual();
+	sendLine(clientFd, "BEST " + formatDouble("%.4f", best->getCurrentFitness()))
+		&& sendSolution(clientFd, *best, *ttpConfig) && sendLine(clientFd, "DONE");
+}
+
+config::GAlgParams SolverServer::makeParams(const Arguments& arguments) const
+{
+	auto params = defaults.gAlgParams;
+	params.maxGAlgDuration = std::chrono::seconds(
+		parseArgument<uint64_t>(arguments, "deadline", params.maxGAlgDuration.count(), parseUnsigned));
+	params.maxPopulationsNum = parseArgument<uint32_t>(arguments, "generations", params.maxPopulationsNum, parseUnsigned);
+	params.populationSize = parseArgument<uint32_t>(arguments, "population", params.populationSize, parseUnsigned);
+	params.crossoverProb = parseArgument<double>(arguments, "crossover", params.crossoverProb, parseDouble);
+	params.mutationProb = parseArgument<double>(arguments, "mutation", params.mutationProb, parseDouble);
+	params.tournamentSize = parseArgument<uint32_t>(arguments, "tournament", params.tournamentSize, parseUnsigned);
+	params.elitismSize = parseArgument<uint32_t>(arguments, "elitism", params.elitismSize, parseUnsigned);
+	const auto crossoverType = arguments.find("crossover_type");
+	if (crossoverType != arguments.end())
+		params.crossoverType = crossoverType->second;
+	if (params.maxGAlgDuration == std::chrono::seconds::zero() && params.maxPopulationsNum == 0)
+		throw std::runtime_error("solve needs deadline or generations limit");
+	return params;
+}
+
+} // namespace server
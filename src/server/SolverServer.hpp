@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <string>
+
+#include "InstanceCache.hpp"
+#include <configuration/GAlgConfig.hpp>
+
+namespace server {
+
+// Solver daemon: instances stay loaded in InstanceCache, every connection is served by a thread pool worker,
+// so connections beyond threads num wait for a free worker. Text protocol over Unix domain socket,
+// one command per line, arguments as key=value:
+//   PING                               -> PONG
+//   LOAD instance=<path>               -> LOADED <cities num> <items num>
+//   SOLVE instance=<path> [deadline=<s>] [generations=<n>] [population=<n>] [crossover=<prob>] [mutation=<prob>]
+//         [crossover_type=<name>] [tournament=<n>] [elitism=<n>] [stream=<n>] [improved_solutions=<0|1>] [log=<0|1>]
+//                                      -> ACCEPTED <request id>, IMPROVED <generation> <elapsed ms> <fitness> on every new best,
+//                                         followed by its TOUR and PACKING lines when improved_solutions=1,
+//                                         then BEST <fitness>, TOUR <city ids>, PACKING <item ids>, DONE
+//   SHUTDOWN                           -> BYE, server stops accepting, running solves are finished
+// Failed commands are answered with ERROR <message>. Omitted arguments are taken from gaConfig.txt. Solves use GA engine,
+// random stream defaults to request id; a solve stops after the population during which its client went away. With log=1 a solve writes its
+// per generation CSV to <RESULTS CSV FILE>_request<request id>, nothing is written to disk otherwise.
+class SolverServer
+{
+public:
+	SolverServer(const config::GAlgConfig& defaults, const config::EvaluationPrecision evaluationPrecision,
+		const std::string& socketPath);
+
+	SolverServer() = delete;
+	SolverServer(const SolverServer&) = delete;
+	SolverServer(SolverServer&&) = delete;
+	~SolverServer() = default;
+
+	SolverServer& operator=(const SolverServer&) = delete;
+	SolverServer& operator=(SolverServer&&) = delete;
+
+	void run();  // blocks until SHUTDOWN
+
+private:
+	using Arguments = std::map<std::string, std::string>;
+
+	void serveClient(const int clientFd);
+	void handleCommand(const int clientFd, const std::string& line);
+	void load(const int clientFd, const Arguments& arguments);
+	void solve(const int clientFd, const Arguments& arguments);
+	config::GAlgParams makeParams(const Arguments& arguments) const;
+
+	const config::GAlgConfig defaults;
+	const std::string socketPath;
+	InstanceCache instanceCache;
+	std::atomic<bool> shutdownRequested;
+	std::atomic<uint64_t> requestsNum;
+};
+
+} // namespace server
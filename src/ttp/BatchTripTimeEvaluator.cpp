@@ -0,0 +1,188 @@
+#include "BatchTripTimeEvaluator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace ttp {
+
+namespace {
+
+// Interleaved by position: [position * lanesNum + lane]; position citiesNum repeats position 0 to close the cycle
+template <class Scalar>
+struct BlockBuffers
+{
+	std::vector<Scalar> xs;
+	std::vector<Scalar> ys;
+	std::vector<Scalar> pickedWeights;
+};
+
+template <class Scalar>
+BlockBuffers<Scalar>& getBlockBuffers(const uint32_t citiesNum)
+{
+	thread_local BlockBuffers<Scalar> buffers;
+	const auto size = static_cast<size_t>(citiesNum + 1) * BatchTripTimeEvaluator<Scalar>::lanesNum;
+	if (buffers.xs.size() < size)
+	{
+		buffers.xs.resize(size);
+		buffers.ys.resize(size);
+		buffers.pickedWeights.resize(size);
+	}
+	return buffers;
+}
+
+} // namespace
+
+template <class Scalar>
+BatchTripTimeEvaluator<Scalar>::BatchTripTimeEvaluator(const config::TtpConfig& ttpConfig)
+	: maxVelocity(static_cast<Scalar>(ttpConfig.maxVelocity))
+	, velocityDropPerWeightUnit(static_cast<Scalar>((ttpConfig.maxVelocity - ttpConfig.minVelocity) / ttpConfig.capacityOfKnapsack))
+{
+}
+
+template <class Scalar>
+void BatchTripTimeEvaluator<Scalar>::computeTripTimes(const std::vector<const std::vector<City>*>& tours,
+	const std::vector<const std::vector<uint32_t>*>& weightsPerCity, std::vector<double>& tripTimes) const
+{
+	tripTimes.resize(tours.size());
+	if (tours.empty())
+		return;
+	const auto citiesNum = static_cast<uint32_t>(tours.front()->size());
+	if (citiesNum < 2)
+	{
+		std::fill(tripTimes.begin(), tripTimes.end(), 0.0);
+		return;
+	}
+	Scalar blockTripTimes[lanesNum];
+	for (auto first = 0u; first < tours.size(); first += lanesNum)
+	{
+		packBlock(tours, weightsPerCity, first);
+		computeBlock(citiesNum, blockTripTimes);
+		const auto lanesUsed = std::min<size_t>(lanesNum, tours.size() - first);
+		std::copy(blockTripTimes, blockTripTimes + lanesUsed, tripTimes.begin() + first);
+	}
+}
+
+template <class Scalar>
+Scalar BatchTripTimeEvaluator<Scalar>::computeTripTime(const std::vector<City>& tour, const std::vector<uint32_t>& weightsPerCity) const
+{
+	const auto citiesNum = static_cast<uint32_t>(tour.size());
+	if (citiesNum < 2)
+		return Scalar(0);
+	Scalar totalWeight = 0;
+	Scalar tripTime = 0;
+	for (auto i = 0u; i < citiesNum; i++)
+	{
+		const auto& current = tour[i];
+		const auto& next = tour[i + 1 == citiesNum ? 0 : i + 1];
+		const Scalar dx = static_cast<Scalar>(next.x) - static_cast<Scalar>(current.x);
+		const Scalar dy = static_cast<Scalar>(next.y) - static_cast<Scalar>(current.y);
+		totalWeight += static_cast<Scalar>(weightsPerCity[current.index]);
+		tripTime += std::sqrt(dx * dx + dy * dy) / (maxVelocity - totalWeight * velocityDropPerWeightUnit);
+	}
+	return tripTime;
+}
+
+template <class Scalar>
+void BatchTripTimeEvaluator<Scalar>::packBlock(const std::vector<const std::vector<City>*>& tours,
+	const std::vector<const std::vector<uint32_t>*>& weightsPerCity, const uint32_t firstTour) const
+{
+	const auto citiesNum = static_cast<uint32_t>(tours.front()->size());
+	auto& buffers = getBlockBuffers<Scalar>(citiesNum);
+	for (auto lane = 0u; lane < lanesNum; lane++)
+	{
+		// last block padded with last tour, its results are dropped
+		const auto tourIndex = std::min<size_t>(firstTour + lane, tours.size() - 1);
+		const auto& tour = *tours[tourIndex];
+		const auto& weights = *weightsPerCity[tourIndex];
+		for (auto i = 0u; i <= citiesNum; i++)
+		{
+			const auto& city = tour[i == citiesNum ? 0 : i];
+			buffers.xs[i * lanesNum + lane] = static_cast<Scalar>(city.x);
+			buffers.ys[i * lanesNum + lane] = static_cast<Scalar>(city.y);
+			buffers.pickedWeights[i * lanesNum + lane] = i == citiesNum ? Scalar(0) : static_cast<Scalar>(weights[city.index]);
+		}
+	}
+}
+
+template <class Scalar>
+void BatchTripTimeEvaluator<Scalar>::computeBlock(const uint32_t citiesNum, Scalar* blockTripTimes) const
+{
+	const auto& buffers = getBlockBuffers<Scalar>(citiesNum);
+	const Scalar* xs = buffers.xs.data();
+	const Scalar* ys = buffers.ys.data();
+	const Scalar* pickedWeights = buffers.pickedWeights.data();
+#if defined(__AVX2__)
+	if constexpr (std::is_same_v<Scalar, double>)
+	{
+		const __m256d maxVelocityVec = _mm256_set1_pd(maxVelocity);
+		const __m256d velocityDropVec = _mm256_set1_pd(velocityDropPerWeightUnit);
+		__m256d totalWeight = _mm256_setzero_pd();
+		__m256d tripTime = _mm256_setzero_pd();
+		__m256d currentX = _mm256_loadu_pd(xs);
+		__m256d currentY = _mm256_loadu_pd(ys);
+		for (auto i = 0u; i < citiesNum; i++)
+		{
+			const __m256d nextX = _mm256_loadu_pd(xs + (i + 1) * lanesNum);
+			const __m256d nextY = _mm256_loadu_pd(ys + (i + 1) * lanesNum);
+			const __m256d dx = _mm256_sub_pd(nextX, currentX);
+			const __m256d dy = _mm256_sub_pd(nextY, currentY);
+			const __m256d distance = _mm256_sqrt_pd(_mm256_fmadd_pd(dx, dx, _mm256_mul_pd(dy, dy)));
+			totalWeight = _mm256_add_pd(totalWeight, _mm256_loadu_pd(pickedWeights + i * lanesNum));
+			const __m256d velocity = _mm256_fnmadd_pd(totalWeight, velocityDropVec, maxVelocityVec);
+			tripTime = _mm256_add_pd(tripTime, _mm256_div_pd(distance, velocity));
+			currentX = nextX;
+			currentY = nextY;
+		}
+		_mm256_storeu_pd(blockTripTimes, tripTime);
+	}
+	else
+	{
+		const __m256 maxVelocityVec = _mm256_set1_ps(maxVelocity);
+		const __m256 velocityDropVec = _mm256_set1_ps(velocityDropPerWeightUnit);
+		__m256 totalWeight = _mm256_setzero_ps();
+		__m256 tripTime = _mm256_setzero_ps();
+		__m256 currentX = _mm256_loadu_ps(xs);
+		__m256 currentY = _mm256_loadu_ps(ys);
+		for (auto i = 0u; i < citiesNum; i++)
+		{
+			const __m256 nextX = _mm256_loadu_ps(xs + (i + 1) * lanesNum);
+			const __m256 nextY = _mm256_loadu_ps(ys + (i + 1) * lanesNum);
+			const __m256 dx = _mm256_sub_ps(nextX, currentX);
+			const __m256 dy = _mm256_sub_ps(nextY, currentY);
+			const __m256 distance = _mm256_sqrt_ps(_mm256_fmadd_ps(dx, dx, _mm256_mul_ps(dy, dy)));
+			totalWeight = _mm256_add_ps(totalWeight, _mm256_loadu_ps(pickedWeights + i * lanesNum));
+			const __m256 velocity = _mm256_fnmadd_ps(totalWeight, velocityDropVec, maxVelocityVec);
+			tripTime = _mm256_add_ps(tripTime, _mm256_div_ps(distance, velocity));
+			currentX = nextX;
+			currentY = nextY;
+		}
+		_mm256_storeu_ps(blockTripTimes, tripTime);
+	}
+#else
+	Scalar totalWeight[lanesNum] = {};
+	std::fill(blockTripTimes, blockTripTimes + lanesNum, Scalar(0));
+	for (auto i = 0u; i < citiesNum; i++)
+	{
+		for (auto lane = 0u; lane < lanesNum; lane++)
+		{
+			const auto current = i * lanesNum + lane;
+			const auto next = current + lanesNum;
+			const Scalar dx = xs[next] - xs[current];
+			const Scalar dy = ys[next] - ys[current];
+			totalWeight[lane] += pickedWeights[current];
+			const Scalar velocity = maxVelocity - totalWeight[lane] * velocityDropPerWeightUnit;
+			blockTripTimes[lane] += std::sqrt(dx * dx + dy * dy) / velocity;
+		}
+	}
+#endif
+}
+
+template class BatchTripTimeEvaluator<double>;
+template class BatchTripTimeEvaluator<float>;
+
+} // namespace ttp
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "City.hpp"
+#include <configuration/TtpConfig.hpp>
+
+namespace ttp {
+
+// Computes trip times of many tours at once, lanesNum tours walked in lockstep.
+// Uses AVX2 when compiled with it, plain loop over lanes otherwise.
+// Works on thread-local buffers, so it is safe to use from many threads.
+// Scalar is double or float; float halves memory traffic and doubles lanes, but sums lose precision on long tours.
+template <class Scalar>
+class BatchTripTimeEvaluator
+{
+public:
+	static constexpr uint32_t lanesNum = 32u / sizeof(Scalar);  // one AVX register
+
+	explicit BatchTripTimeEvaluator(const config::TtpConfig& ttpConfig);
+
+	// weightsPerCity[i] - picked weight per city id for tours[i]; all tours must have the same length
+	void computeTripTimes(const std::vector<const std::vector<City>*>& tours,
+		const std::vector<const std::vector<uint32_t>*>& weightsPerCity, std::vector<double>& tripTimes) const;
+	// single tour, plain loop
+	Scalar computeTripTime(const std::vector<City>& tour, const std::vector<uint32_t>& weightsPerCity) const;
+
+private:
+	void packBlock(const std::vector<const std::vector<City>*>& tours,
+		const std::vector<const std::vector<uint32_t>*>& weightsPerCity, const uint32_t firstTour) const;
+	void computeBlock(const uint32_t citiesNum, Scalar* blockTripTimes) const;
+
+	const Scalar maxVelocity;
+	const Scalar velocityDropPerWeightUnit;
+};
+
+// defined for double and float in cpp, together with their intrinsics
+extern template class BatchTripTimeEvaluator<double>;
+extern template class BatchTripTimeEvaluator<float>;
+
+} // namespace ttp
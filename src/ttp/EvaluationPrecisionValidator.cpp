@@ -0,0 +1,66 @@
+#include "EvaluationPrecisionValidator.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+#include "TtpIndividual.hpp"
+#include <utils/RandomUtils.hpp>
+
+namespace ttp {
+
+std::string PrecisionDeviation::getStringRepresentation() const
+{
+	char buffer[200];
+	std::snprintf(buffer, sizeof(buffer), "individuals: %u; max absolute fitness deviation: %.6g; max deviation relative to trip time: %.3e",
+		individualsNum, maxAbsoluteDeviation, maxRelativeDeviation);
+	return buffer;
+}
+
+EvaluationPrecisionValidator::EvaluationPrecisionValidator(const uint32_t individualsNum)
+	: individualsNum(individualsNum)
+{
+}
+
+PrecisionDeviation EvaluationPrecisionValidator::validate(const config::TtpConfig& ttpConfig) const
+{
+	auto doubleConfig = ttpConfig;
+	doubleConfig.evaluationPrecision = config::EvaluationPrecision::doublePrecision;
+	auto floatConfig = ttpConfig;
+	floatConfig.evaluationPrecision = config::EvaluationPrecision::singlePrecision;
+
+	auto& random = utils::rnd::Random::getInstance();
+	std::vector<std::unique_ptr<TtpIndividual>> reference;
+	std::vector<std::unique_ptr<TtpIndividual>> batchEvaluated;
+	std::vector<std::unique_ptr<TtpIndividual>> singleEvaluated;
+	for (auto i = 0u; i < individualsNum; i++)
+	{
+		reference.push_back(TtpIndividual::createRandom(doubleConfig, random.getRndGen()));
+		auto cityChain = reference.back()->getCityChain();
+		batchEvaluated.push_back(std::make_unique<TtpIndividual>(floatConfig, TspSolution(floatConfig, std::vector<City>(cityChain))));
+		singleEvaluated.push_back(std::make_unique<TtpIndividual>(floatConfig, TspSolution(floatConfig, std::move(cityChain))));
+	}
+	TtpIndividual::evaluateAll(reference);
+	TtpIndividual::evaluateAll(batchEvaluated);
+	for (auto& individual : singleEvaluated)
+		individual->evaluate();
+
+	PrecisionDeviation deviation{ individualsNum, 0.0, 0.0 };
+	for (auto i = 0u; i < individualsNum; i++)
+	{
+		const double referenceFitness = reference[i]->getCurrentFitness();
+		const double tripTime = reference[i]->getKnapsack().getKnapsackValue() - referenceFitness;
+		for (const auto* evaluated : { batchEvaluated[i].get(), singleEvaluated[i].get() })
+		{
+			const double absoluteDeviation = std::abs(evaluated->getCurrentFitness() - referenceFitness);
+			deviation.maxAbsoluteDeviation = std::max(deviation.maxAbsoluteDeviation, absoluteDeviation);
+			if (tripTime > 0.0)
+				deviation.maxRelativeDeviation = std::max(deviation.maxRelativeDeviation, absoluteDeviation / tripTime);
+		}
+	}
+	return deviation;
+}
+
+} // namespace ttp
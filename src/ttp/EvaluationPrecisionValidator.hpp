@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include <configuration/TtpConfig.hpp>
+
+namespace ttp {
+
+struct PrecisionDeviation
+{
+	std::string getStringRepresentation() const;
+
+	uint32_t individualsNum;
+	double maxAbsoluteDeviation;  // of fitness, single vs double precision
+	double maxRelativeDeviation;  // absolute deviation / trip time in double precision
+};
+
+// Evaluates the same random tours, packed greedily in double precision, with both precisions,
+// through batch and single individual paths
+class EvaluationPrecisionValidator
+{
+public:
+	explicit EvaluationPrecisionValidator(const uint32_t individualsNum);
+
+	PrecisionDeviation validate(const config::TtpConfig& ttpConfig) const;
+
+private:
+	const uint32_t individualsNum;
+};
+
+} // namespace ttp
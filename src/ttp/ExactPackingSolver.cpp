@@ -0,0 +1,117 @@
+#include "ExactPackingSolver.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace ttp {
+
+namespace {
+
+struct PackingDpScratch
+{
+	std::vector<double> values;  // indexed by carried weight, -inf for unreachable weights
+	std::vector<double> nextValues;
+	std::vector<double> inverseVelocities;  // indexed by carried weight
+	std::vector<double> distanceToEnd;  // indexed by tour position
+	std::vector<const Item*> items;  // considered, in tour order
+	std::vector<uint64_t> decisions;  // row of bits per considered item, set when item is taken at given weight
+};
+
+PackingDpScratch& getPackingDpScratch()
+{
+	thread_local PackingDpScratch scratch;
+	return scratch;
+}
+
+constexpr uint32_t bitsPerWord = 64u;
+
+} // namespace
+
+ExactPackingSolver::ExactPackingSolver(const config::TtpConfig& ttpConfig)
+	: ttpConfig(ttpConfig)
+{
+}
+
+uint64_t ExactPackingSolver::countStates(const config::TtpConfig& ttpConfig)
+{
+	return static_cast<uint64_t>(ttpConfig.items.size()) * (static_cast<uint64_t>(ttpConfig.capacityOfKnapsack) + 1);
+}
+
+Knapsack ExactPackingSolver::solve(const std::vector<City>& tour) const
+{
+	auto& scratch = getPackingDpScratch();
+	const auto capacity = ttpConfig.capacityOfKnapsack;
+	const auto citiesNum = static_cast<uint32_t>(tour.size());
+	const auto wordsPerRow = capacity / bitsPerWord + 1;
+	const double velocityDropPerWeightUnit = (ttpConfig.maxVelocity - ttpConfig.minVelocity) / capacity;
+	scratch.inverseVelocities.resize(capacity + 1);
+	for (auto weight = 0u; weight <= capacity; weight++)
+		scratch.inverseVelocities[weight] = 1.0 / (ttpConfig.maxVelocity - weight * velocityDropPerWeightUnit);
+	scratch.distanceToEnd.resize(citiesNum + 1);
+	scratch.distanceToEnd[citiesNum] = 0.0;
+	for (auto pos = citiesNum; pos-- > 0;)
+		scratch.distanceToEnd[pos] = scratch.distanceToEnd[pos + 1] + tour[pos].getDistance(tour[pos + 1 == citiesNum ? 0 : pos + 1]);
+	scratch.values.assign(capacity + 1, -std::numeric_limits<double>::infinity());
+	scratch.nextValues.assign(capacity + 1, -std::numeric_limits<double>::infinity());
+	scratch.values[0] = 0.0;
+	scratch.items.clear();
+	scratch.decisions.clear();
+
+	uint32_t maxReachableWeight = 0u;
+	for (auto pos = 0u; pos < citiesNum; pos++)
+	{
+		const auto cityId = tour[pos].index;
+		const auto first = ttpConfig.rankedItemsPerCity.cbegin() + ttpConfig.itemsPerCityOffsets[cityId];
+		const auto last = ttpConfig.rankedItemsPerCity.cbegin() + ttpConfig.itemsPerCityOffsets[cityId + 1];
+		for (auto it = first; it != last && it->breakEvenDistance > scratch.distanceToEnd[pos]; ++it)
+		{
+			const auto& item = it->item;
+			if (item.weight > capacity)
+				continue;
+			scratch.items.push_back(&item);
+			scratch.decisions.resize(scratch.decisions.size() + wordsPerRow, 0u);
+			uint64_t* row = scratch.decisions.data() + scratch.decisions.size() - wordsPerRow;
+			const auto newMaxReachableWeight = static_cast<uint32_t>(std::min<uint64_t>(capacity, static_cast<uint64_t>(maxReachableWeight) + item.weight));
+			const auto* values = scratch.values.data();
+			auto* nextValues = scratch.nextValues.data();
+			std::copy(values, values + std::min(item.weight, newMaxReachableWeight + 1), nextValues);
+			// decisions of one word are gathered in register, values loop stays branchless
+			for (auto word = item.weight / bitsPerWord; word <= newMaxReachableWeight / bitsPerWord; word++)
+			{
+				const auto wordBegin = word * bitsPerWord;
+				const auto firstWeight = std::max(item.weight, wordBegin);
+				const auto lastWeight = std::min(newMaxReachableWeight, wordBegin + bitsPerWord - 1);
+				uint64_t takenBits = 0u;
+				for (auto weight = firstWeight; weight <= lastWeight; weight++)
+				{
+					const double taken = values[weight - item.weight] + item.profit;
+					const bool isTaken = taken > values[weight];
+					nextValues[weight] = isTaken ? taken : values[weight];
+					takenBits |= static_cast<uint64_t>(isTaken) << (weight - wordBegin);
+				}
+				row[word] = takenBits;
+			}
+			scratch.values.swap(scratch.nextValues);
+			maxReachableWeight = newMaxReachableWeight;
+		}
+		const double distance = tour[pos].getDistance(tour[pos + 1 == citiesNum ? 0 : pos + 1]);
+		for (auto weight = 0u; weight <= maxReachableWeight; weight++)
+			scratch.values[weight] -= distance * scratch.inverseVelocities[weight];
+	}
+
+	auto weight = static_cast<uint32_t>(std::distance(scratch.values.cbegin(),
+		std::max_element(scratch.values.cbegin(), scratch.values.cbegin() + maxReachableWeight + 1)));
+	Knapsack knapsack(capacity, static_cast<uint32_t>(ttpConfig.cities.size()));
+	for (auto i = scratch.items.size(); i-- > 0;)
+	{
+		const uint64_t* row = scratch.decisions.data() + i * wordsPerRow;
+		if ((row[weight / bitsPerWord] >> (weight % bitsPerWord)) & 1u)
+		{
+			knapsack.addItem(*scratch.items[i]);
+			weight -= scratch.items[i]->weight;
+		}
+	}
+	return knapsack;
+}
+
+} // namespace ttp
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "City.hpp"
+#include "Knapsack.hpp"
+#include <configuration/TtpConfig.hpp>
+
+namespace ttp {
+
+// Optimal packing for a fixed tour (packing while travelling). Cities are processed in tour order by dynamic programming
+// over carried weight 0..capacity, keeping best profit minus time so far for every weight. Items which don't pay off
+// alone on the rest of the tour are skipped, as carrying them on top of other items only costs more time.
+// Take / skip decisions are kept as bit rows, 64 weights per word, so they take items * (capacity + 1) bits.
+// Works on thread-local buffers, so it is safe to use from many threads.
+class ExactPackingSolver
+{
+public:
+	explicit ExactPackingSolver(const config::TtpConfig& ttpConfig);
+
+	static uint64_t countStates(const config::TtpConfig& ttpConfig);  // worst case decision bits, bounds time as well
+	Knapsack solve(const std::vector<City>& tour) const;
+
+private:
+	const config::TtpConfig& ttpConfig;
+};
+
+} // namespace ttp
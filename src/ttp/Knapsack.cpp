@@ -1,40 +1,79 @@
 #include "Knapsack.hpp"
 
 #include <algorithm>
-#include <numeric>
+#include <atomic>
+#include <utility>
 
 namespace ttp {
 
-Knapsack::Knapsack(const uint32_t capacity)
+namespace {
+
+// use_count() is a relaxed load. Owner which dropped its share did it with release decrement after its last reads,
+// so acquire fence after seeing 1 keeps our writes from racing with them. Count can't grow meanwhile, copying
+// needs the only remaining owner, which is ours.
+template<class Content>
+bool isShared(const std::shared_ptr<Content>& content)
+{
+	if (content.use_count() > 1)
+		return true;
+	std::atomic_thread_fence(std::memory_order_acquire);
+	return false;
+}
+
+} // namespace
+
+Knapsack::Knapsack(const uint32_t capacity, const uint32_t citiesNum)
 	: capacity(capacity)
 	, currentWeight(0u)
+	, content(std::make_shared<Content>(Content{ std::vector<Item>(), std::vector<uint32_t>(citiesNum + 1, 0u) }))
 	, knapsackValue(0u)
 {
 }
 
-const ItemsPerCity& Knapsack::getItemsPerCity() const
+Knapsack& Knapsack::operator=(const Knapsack& other)
 {
-	return itemsPerCity;
+	currentWeight = other.currentWeight;
+	content = other.content;
+	knapsackValue = other.knapsackValue;
+	return *this;
+}
+
+const std::vector<Item>& Knapsack::getItems() const
+{
+	return content->items;
 }
 
 uint32_t Knapsack::getWeightForCity(const uint32_t cityId) const
 {
-	if (itemsPerCity.find(cityId) == itemsPerCity.end())
-		return 0u;
-	const auto& items = itemsPerCity.at(cityId);
-	return std::accumulate(items.cbegin(), items.cend(), 0, [](const auto& acc, const auto& item) {return acc + item.weight; });
+	return content->weightPerCity[cityId];
+}
+
+const std::vector<uint32_t>& Knapsack::getWeightsPerCity() const
+{
+	return content->weightPerCity;
 }
 
 void Knapsack::clear()
 {
-	itemsPerCity.clear();
+	if (isShared(content))  // no point in copying content which is dropped anyway
+	{
+		const auto citiesNum = content->weightPerCity.size();
+		content = std::make_shared<Content>(Content{ std::vector<Item>(), std::vector<uint32_t>(citiesNum, 0u) });
+	}
+	else
+	{
+		content->items.clear();
+		std::fill(content->weightPerCity.begin(), content->weightPerCity.end(), 0u);
+	}
 	currentWeight = 0u;
 	knapsackValue = 0u;
 }
 
 void Knapsack::addItem(const Item& item)
 {
-	itemsPerCity[item.cityId].push_back(item);
+	auto& ownContent = materializeContent();
+	ownContent.items.push_back(item);
+	ownContent.weightPerCity[item.cityId] += item.weight;
 	currentWeight += item.weight;
 	knapsackValue += item.profit;
 }
@@ -54,20 +93,28 @@ uint32_t Knapsack::getCurrentWeight() const
 	return currentWeight;
 }
 
-std::string Knapsack::getStringRepresentation() const
+std::string Knapsack::getStringRepresentation(const config::TtpConfig& ttpConfig) const
 {
 	std::string result;
 	const std::string resultDelimiter = " ; ";
 	const std::string subResultDelimiter = ", ";
-	for (const auto& itemsInCity : itemsPerCity)
+	// items grouped by city, cities and items within them in ascending order of ids
+	std::vector<std::pair<uint32_t, uint32_t>> cityAndItemIds;
+	cityAndItemIds.reserve(content->items.size());
+	for (const auto& item : content->items)
+		cityAndItemIds.emplace_back(ttpConfig.getOriginalCityId(item.cityId), item.index);
+	std::sort(cityAndItemIds.begin(), cityAndItemIds.end());
+	for (auto it = cityAndItemIds.cbegin(); it != cityAndItemIds.cend();)
 	{
-		result.append(std::to_string(itemsInCity.first)).append(": [");
-		std::string subResult;
-		for (const auto& item : itemsInCity.second)
-			subResult.append(std::to_string(item.index)).append(subResultDelimiter);
-		if (!subResult.empty())
-			subResult = subResult.substr(0, subResult.length() - subResultDelimiter.length());
-		result.append(subResult).append("]").append(resultDelimiter);
+		const auto cityId = it->first;
+		result.append(std::to_string(cityId)).append(": [");
+		for (auto first = it; it != cityAndItemIds.cend() && it->first == cityId; ++it)
+		{
+			if (it != first)
+				result.append(subResultDelimiter);
+			result.append(std::to_string(it->second));
+		}
+		result.append("]").append(resultDelimiter);
 	}
 	if (!result.empty())
 		result = result.substr(0, result.length() - resultDelimiter.length());
@@ -75,4 +122,16 @@ std::string Knapsack::getStringRepresentation() const
 	return result;
 }
 
+uint64_t Knapsack::getMemoryFootprint() const
+{
+	return sizeof(Content) + content->items.capacity() * sizeof(Item) + content->weightPerCity.capacity() * sizeof(uint32_t);
+}
+
+Knapsack::Content& Knapsack::materializeContent()
+{
+	if (isShared(content))
+		content = std::make_shared<Content>(*content);
+	return *content;
+}
+
 } // namespace ttp
@@ -1,41 +1,50 @@
 #pragma once
 
 #include <cstdint>
-#include <unordered_map>
+#include <memory>
+#include <vector>
 
 #include "Item.hpp"
 #include <configuration/TtpConfig.hpp>
 
 namespace ttp {
 
-using ItemsPerCity = std::unordered_map<uint32_t, std::vector<Item>>;
-
 class Knapsack
 {
 public:
-	explicit Knapsack(const uint32_t capacity);
+	Knapsack(const uint32_t capacity, const uint32_t citiesNum);
 
 	Knapsack() = delete;
 	Knapsack(const Knapsack&) = default;
 	Knapsack(Knapsack&&) = default;
 	~Knapsack() = default;
 	
-	Knapsack& operator=(const Knapsack&) = delete;
+	Knapsack& operator=(const Knapsack& other);  // shares storage, both knapsacks must have same capacity
 	Knapsack& operator=(Knapsack&&) = delete;
 
-	const ItemsPerCity& getItemsPerCity() const;
+	const std::vector<Item>& getItems() const;  // in packing order
 	uint32_t getWeightForCity(const uint32_t cityId) const;
+	const std::vector<uint32_t>& getWeightsPerCity() const;  // indexed by city id
 	void clear();
 	void addItem(const Item& item);
 	uint32_t getKnapsackValue() const;
 	uint32_t getKnapsackCapacity() const;
 	uint32_t getCurrentWeight() const;
-	std::string getStringRepresentation() const;
+	std::string getStringRepresentation(const config::TtpConfig& ttpConfig) const;  // cities with original ids, ascending
+	uint64_t getMemoryFootprint() const;  // heap bytes of content, as if it wasn't shared
 
 private:
+	struct Content
+	{
+		std::vector<Item> items;  // in packing order
+		std::vector<uint32_t> weightPerCity;  // indexed by city id
+	};
+
+	Content& materializeContent();
+
 	const uint32_t capacity;
 	uint32_t currentWeight;
-	ItemsPerCity itemsPerCity;
+	std::shared_ptr<Content> content;  // copy on write, shared between clones
 	uint32_t knapsackValue;
 };
 
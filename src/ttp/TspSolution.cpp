@@ -1,28 +1,67 @@
 #include "TspSolution.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <iterator>
+#include <limits>
+#include <memory>
 #include <unordered_map>
-#include <unordered_set>
 #include <utility>
 
 #include <utils/RandomUtils.hpp>
 
 namespace ttp {
 
+namespace {
+
+constexpr uint32_t maxErxNeighbours = 4u;
+
+// Buffers reused by crossover operators, indexed by city id (ids start from 1)
+struct CrossoverScratch
+{
+	std::vector<uint32_t> positions;
+	std::vector<uint8_t> flags;
+	std::vector<uint32_t> neighbours;
+	std::vector<uint32_t> neighboursNum;
+	std::vector<uint32_t> unvisited;
+};
+
+CrossoverScratch& getCrossoverScratch(const uint32_t citiesNum)
+{
+	thread_local CrossoverScratch scratch;
+	if (scratch.positions.size() < citiesNum + 1)
+	{
+		scratch.positions.resize(citiesNum + 1);
+		scratch.flags.resize(citiesNum + 1);
+		scratch.neighbours.resize((citiesNum + 1) * maxErxNeighbours);
+		scratch.neighboursNum.resize(citiesNum + 1);
+		scratch.unvisited.resize(citiesNum);
+	}
+	return scratch;
+}
+
+} // namespace
+
 TspSolution::TspSolution(const config::TtpConfig& ttpConfig, std::vector<City>&& cities)
 	: ttpConfig(ttpConfig)
-	, cityChain(std::move(cities))
+	, sharedCityChain(std::make_shared<std::vector<City>>(std::move(cities)))
+{
+}
+
+TspSolution& TspSolution::operator=(const TspSolution& other)
 {
+	sharedCityChain = other.sharedCityChain;
+	return *this;
 }
 
 const std::vector<ttp::City>& TspSolution::getCityChain() const
 {
-	return cityChain;
+	return *sharedCityChain;
 }
 
 double TspSolution::getTotalDistance() const
 {
+	const auto& cityChain = getCityChain();
 	if (cityChain.size() < 2)
 		return 0;
 
@@ -37,6 +76,7 @@ double TspSolution::getTotalDistance() const
 
 uint32_t TspSolution::getStepsNumTo(const uint32_t refCityId, const uint32_t destCityId) const
 {
+	const auto& cityChain = getCityChain();
 	auto stepsNum = 0u;
 	auto refCityPos = getIndexOfCityInChain(refCityId);
 	for (auto i = refCityPos; i < cityChain.size(); i++)
@@ -56,15 +96,39 @@ uint32_t TspSolution::getStepsNumTo(const uint32_t refCityId, const uint32_t des
 
 uint32_t TspSolution::getIndexOfCityInChain(const uint32_t cityId) const
 {
+	const auto& cityChain = getCityChain();
 	return static_cast<uint32_t>(
 		std::distance(cityChain.cbegin(),
 			std::find_if(cityChain.cbegin(), cityChain.cend(), [cityId](const auto& city) {return city.index == cityId; }))
 		);
 }
 
+uint64_t TspSolution::getTourHash() const
+{
+	// same hash for all rotations and both directions of the cycle: start from city 1, go towards smaller neighbour
+	const auto& cityChain = getCityChain();
+	const auto citiesNum = static_cast<uint32_t>(cityChain.size());
+	if (citiesNum == 0u)
+		return 0u;
+	auto startPos = getIndexOfCityInChain(1u);
+	if (startPos == citiesNum)
+		startPos = 0u;
+	const auto& next = cityChain[(startPos + 1) % citiesNum];
+	const auto& prev = cityChain[(startPos + citiesNum - 1) % citiesNum];
+	const uint32_t step = next.index <= prev.index ? 1u : citiesNum - 1u;
+	uint64_t hash = 0xcbf29ce484222325ull;
+	for (auto i = 0u, pos = startPos; i < citiesNum; i++, pos = (pos + step) % citiesNum)
+	{
+		hash ^= cityChain[pos].index;
+		hash *= 0x100000001b3ull;
+	}
+	return hash;
+}
+
 void TspSolution::mutation()
 {
 	// IRGIBNNM
+	auto& cityChain = materializeCityChain();
 	//const int32_t neighbourhoodThreshold = static_cast<int32_t>(cityChain.size()) / 100 + 1;
 	const int32_t neighbourhoodThreshold = 5;
 	auto& random = utils::rnd::Random::getInstance();
@@ -89,6 +153,7 @@ void TspSolution::mutation()
 TspSolution TspSolution::crossoverNrx(const double parent1TotalTime, const TspSolution& parent2, const double parent2TotalTime) const
 {
 	// NRX
+	const auto& cityChain = getCityChain();
 	std::unordered_map<uint32_t, double> stepsSum;
 	stepsSum.reserve(cityChain.size());
 	auto& random = utils::rnd::Random::getInstance();
@@ -111,6 +176,140 @@ TspSolution TspSolution::crossoverNrx(const double parent1TotalTime, const TspSo
 
 std::pair<TspSolution, TspSolution> TspSolution::crossoverPmx(const TspSolution& parent2) const
 {
+	auto [partitionIndex1, partitionIndex2] = drawPartitionIndices();
+	return std::make_pair(
+		TspSolution(ttpConfig, pmx(*this, parent2, partitionIndex1, partitionIndex2)),
+		TspSolution(ttpConfig, pmx(parent2, *this, partitionIndex1, partitionIndex2))
+	);
+}
+
+std::pair<TspSolution, TspSolution> TspSolution::crossoverOx(const TspSolution& parent2) const
+{
+	auto [partitionIndex1, partitionIndex2] = drawPartitionIndices();
+	return std::make_pair(
+		TspSolution(ttpConfig, ox(*this, parent2, partitionIndex1, partitionIndex2)),
+		TspSolution(ttpConfig, ox(parent2, *this, partitionIndex1, partitionIndex2))
+	);
+}
+
+std::pair<TspSolution, TspSolution> TspSolution::crossoverCx(const TspSolution& parent2) const
+{
+	// CX - cities keep positions of either parent, alternating between cycles
+	const auto& cityChain = getCityChain();
+	const auto citiesNum = static_cast<uint32_t>(cityChain.size());
+	auto& scratch = getCrossoverScratch(citiesNum);
+	for (auto i = 0u; i < citiesNum; i++)
+		scratch.positions[cityChain[i].index] = i;
+	std::fill_n(scratch.flags.begin(), citiesNum + 1, 0);
+
+	std::vector<City> offspringCities1(citiesNum);
+	std::vector<City> offspringCities2(citiesNum);
+	bool takeFromThis = true;
+	for (auto cycleStart = 0u; cycleStart < citiesNum; cycleStart++)
+	{
+		if (scratch.flags[cycleStart])
+			continue;
+		auto i = cycleStart;
+		do
+		{
+			scratch.flags[i] = 1;
+			offspringCities1[i] = takeFromThis ? cityChain[i] : parent2.getCityChain()[i];
+			offspringCities2[i] = takeFromThis ? parent2.getCityChain()[i] : cityChain[i];
+			i = scratch.positions[parent2.getCityChain()[i].index];
+		} while (i != cycleStart);
+		takeFromThis = !takeFromThis;
+	}
+
+	return std::make_pair(
+		TspSolution(ttpConfig, std::move(offspringCities1)),
+		TspSolution(ttpConfig, std::move(offspringCities2))
+	);
+}
+
+TspSolution TspSolution::crossoverErx(const TspSolution& parent2) const
+{
+	// ERX - adjacency table of both parents kept in flat arrays, at most 4 neighbours per city
+	const auto& cityChain = getCityChain();
+	const auto citiesNum = static_cast<uint32_t>(cityChain.size());
+	auto& scratch = getCrossoverScratch(citiesNum);
+	std::fill_n(scratch.neighboursNum.begin(), citiesNum + 1, 0);
+	auto addNeighbour = [&scratch](const uint32_t cityId, const uint32_t neighbourId) {
+		auto* neighbours = &scratch.neighbours[cityId * maxErxNeighbours];
+		auto& neighboursNum = scratch.neighboursNum[cityId];
+		if (std::find(neighbours, neighbours + neighboursNum, neighbourId) == neighbours + neighboursNum)
+			neighbours[neighboursNum++] = neighbourId;
+	};
+	for (const auto* parent : { &cityChain, &parent2.getCityChain() })
+	{
+		for (auto i = 0u; i < citiesNum; i++)
+		{
+			auto cityId = (*parent)[i].index;
+			addNeighbour(cityId, (*parent)[i == 0 ? citiesNum - 1 : i - 1].index);
+			addNeighbour(cityId, (*parent)[i == citiesNum - 1 ? 0 : i + 1].index);
+		}
+	}
+
+	// unvisited cities kept in array with back lookup, so that random pick and removal are O(1)
+	for (auto i = 0u; i < citiesNum; i++)
+	{
+		scratch.unvisited[i] = cityChain[i].index;
+		scratch.positions[cityChain[i].index] = i;
+	}
+	auto unvisitedNum = citiesNum;
+	auto removeFromUnvisited = [&scratch, &unvisitedNum](const uint32_t cityId) {
+		auto pos = scratch.positions[cityId];
+		auto lastId = scratch.unvisited[--unvisitedNum];
+		scratch.unvisited[pos] = lastId;
+		scratch.positions[lastId] = pos;
+	};
+
+	auto& random = utils::rnd::Random::getInstance();
+	std::vector<City> offspringCities;
+	offspringCities.reserve(citiesNum);
+	auto currentId = cityChain[random.getRandomUint(0, citiesNum - 1)].index;
+	while (true)
+	{
+		offspringCities.push_back(ttpConfig.cities[currentId - 1]);
+		removeFromUnvisited(currentId);
+		if (unvisitedNum == 0)
+			break;
+
+		const auto* currentNeighbours = &scratch.neighbours[currentId * maxErxNeighbours];
+		for (auto k = 0u; k < scratch.neighboursNum[currentId]; k++)
+		{
+			auto neighbourId = currentNeighbours[k];
+			auto* neighbours = &scratch.neighbours[neighbourId * maxErxNeighbours];
+			auto& neighboursNum = scratch.neighboursNum[neighbourId];
+			auto it = std::find(neighbours, neighbours + neighboursNum, currentId);
+			if (it != neighbours + neighboursNum)
+			{
+				*it = neighbours[neighboursNum - 1];
+				neighboursNum--;
+			}
+		}
+
+		uint32_t nextId = 0u;
+		uint32_t fewestNeighbours = std::numeric_limits<uint32_t>::max();
+		for (auto k = 0u; k < scratch.neighboursNum[currentId]; k++)
+		{
+			auto neighbourId = currentNeighbours[k];
+			if (scratch.neighboursNum[neighbourId] < fewestNeighbours)
+			{
+				fewestNeighbours = scratch.neighboursNum[neighbourId];
+				nextId = neighbourId;
+			}
+		}
+		if (nextId == 0u)  // dead end, continue from random unvisited city
+			nextId = scratch.unvisited[random.getRandomUint(0, unvisitedNum - 1)];
+		scratch.neighboursNum[currentId] = 0;
+		currentId = nextId;
+	}
+	return TspSolution(ttpConfig, std::move(offspringCities));
+}
+
+std::pair<uint32_t, uint32_t> TspSolution::drawPartitionIndices() const
+{
+	const auto& cityChain = getCityChain();
 	auto& random = utils::rnd::Random::getInstance();
 	uint32_t partitionIndex1 = random.getRandomUint(0, static_cast<uint32_t>(cityChain.size() - 1));
 	uint32_t partitionIndex2 = partitionIndex1;
@@ -118,71 +317,104 @@ std::pair<TspSolution, TspSolution> TspSolution::crossoverPmx(const TspSolution&
 		partitionIndex2 = random.getRandomUint(0, static_cast<uint32_t>(cityChain.size() - 1));
 	if (partitionIndex2 < partitionIndex1)
 		std::swap(partitionIndex1, partitionIndex2);
-	
-	return std::make_pair(
-		TspSolution(ttpConfig, pmx(*this, parent2, partitionIndex1, partitionIndex2)),
-		TspSolution(ttpConfig, pmx(parent2, *this, partitionIndex1, partitionIndex2))
-	);
+	return std::make_pair(partitionIndex1, partitionIndex2);
 }
 
 std::vector<City> TspSolution::pmx(const TspSolution& parent1,
 	const TspSolution& parent2, const uint32_t partitionIndex1, const uint32_t partitionIndex2) const
 {
-	// use some extra memory to speed up lookups
-	std::unordered_map<uint32_t, uint32_t> backCityIndexLookup;
-	backCityIndexLookup.reserve(parent1.cityChain.size());
-	for (auto i = 0u; i < parent1.cityChain.size(); i++)
-		backCityIndexLookup[parent1.cityChain[i].index] = i;
-	std::unordered_set<uint32_t> alreadyInOffspring;
-	alreadyInOffspring.reserve(partitionIndex2 - partitionIndex1 + 1);
-	std::vector<City> offspringCities(parent1.cityChain.size());
+	// flat lookups indexed by city id instead of hash containers
+	const auto citiesNum = static_cast<uint32_t>(parent1.getCityChain().size());
+	auto& scratch = getCrossoverScratch(citiesNum);
+	for (auto i = 0u; i < citiesNum; i++)
+		scratch.positions[parent1.getCityChain()[i].index] = i;
+	std::fill_n(scratch.flags.begin(), citiesNum + 1, 0);
+	std::vector<City> offspringCities(citiesNum);
 
 	// copy cities from random slice in parent1
 	for (auto i = partitionIndex1; i < partitionIndex2; i++)
 	{
-		offspringCities[i] = parent1.cityChain[i];
-		alreadyInOffspring.insert(offspringCities[i].index);
+		offspringCities[i] = parent1.getCityChain()[i];
+		scratch.flags[offspringCities[i].index] = 1;
 	}
 
-	// first part to the left of slice
-	for (auto i = 0u; i < partitionIndex1; i++)
-	{
-		uint32_t candidateId = parent2.cityChain[i].index;
-		uint32_t indexOfCandidate = i;
-		while (alreadyInOffspring.find(candidateId) != alreadyInOffspring.end())
+	auto fillFromParent2 = [&](const uint32_t from, const uint32_t to) {
+		for (auto i = from; i < to; i++)
 		{
-			indexOfCandidate = backCityIndexLookup[candidateId];
-			candidateId = parent2.cityChain[indexOfCandidate].index;
+			uint32_t candidateId = parent2.getCityChain()[i].index;
+			uint32_t indexOfCandidate = i;
+			while (scratch.flags[candidateId])
+			{
+				indexOfCandidate = scratch.positions[candidateId];
+				candidateId = parent2.getCityChain()[indexOfCandidate].index;
+			}
+			offspringCities[i] = parent2.getCityChain()[indexOfCandidate];
 		}
-		offspringCities[i] = parent2.cityChain[indexOfCandidate];
+	};
+	// first part to the left of slice
+	fillFromParent2(0u, partitionIndex1);
+	// second part to the right of slice
+	fillFromParent2(partitionIndex2, citiesNum);
+
+	return offspringCities;
+}
+
+std::vector<City> TspSolution::ox(const TspSolution& parent1,
+	const TspSolution& parent2, const uint32_t partitionIndex1, const uint32_t partitionIndex2) const
+{
+	const auto citiesNum = static_cast<uint32_t>(parent1.getCityChain().size());
+	auto& scratch = getCrossoverScratch(citiesNum);
+	std::fill_n(scratch.flags.begin(), citiesNum + 1, 0);
+	std::vector<City> offspringCities(citiesNum);
+
+	// copy cities from random slice in parent1
+	for (auto i = partitionIndex1; i < partitionIndex2; i++)
+	{
+		offspringCities[i] = parent1.getCityChain()[i];
+		scratch.flags[offspringCities[i].index] = 1;
 	}
 
-	// second part to the right of slice
-	for (auto i = partitionIndex2; i < parent2.cityChain.size(); i++)
+	// remaining positions filled in parent2 order, both starting right after the slice
+	auto offspringPos = partitionIndex2 % citiesNum;
+	for (auto k = 0u; k < citiesNum; k++)
 	{
-		uint32_t candidateId = parent2.cityChain[i].index;
-		uint32_t indexOfCandidate = i;
-		while (alreadyInOffspring.find(candidateId) != alreadyInOffspring.end())
-		{
-			indexOfCandidate = backCityIndexLookup[candidateId];
-			candidateId = parent2.cityChain[indexOfCandidate].index;
-		}
-		offspringCities[i] = parent2.cityChain[indexOfCandidate];
+		const auto& candidate = parent2.getCityChain()[(partitionIndex2 + k) % citiesNum];
+		if (scratch.flags[candidate.index])
+			continue;
+		offspringCities[offspringPos] = candidate;
+		offspringPos = (offspringPos + 1) % citiesNum;
 	}
 
 	return offspringCities;
 }
 
+std::vector<City>& TspSolution::materializeCityChain()
+{
+	// copy on write, solutions cloned from the same parent share chain until first modification; clone dropped on other
+	// thread released the chain after reading it, the fence pairs with that before chain is modified in place
+	if (sharedCityChain.use_count() > 1)
+		sharedCityChain = std::make_shared<std::vector<City>>(*sharedCityChain);
+	else
+		std::atomic_thread_fence(std::memory_order_acquire);
+	return *sharedCityChain;
+}
+
 std::string TspSolution::getStringRepresentation() const
 {
+	const auto& cityChain = getCityChain();
 	std::string result;
 	const std::string delimiter = " - ";
 	for (const auto& city : cityChain)
-		result.append(std::to_string(city.index)).append(delimiter);
+		result.append(std::to_string(ttpConfig.getOriginalCityId(city.index))).append(delimiter);
 	if (!result.empty())
 		result = result.substr(0, result.length() - delimiter.length());
 	result += " ; total distance: " + std::to_string(getTotalDistance());
 	return result;
 }
 
+uint64_t TspSolution::getMemoryFootprint() const
+{
+	return sizeof(std::vector<City>) + sharedCityChain->capacity() * sizeof(City);
+}
+
 } // namespace ttp
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "City.hpp"
@@ -18,7 +19,7 @@ public:
 	TspSolution(TspSolution&&) = default;
 	~TspSolution() = default;
 
-	TspSolution& operator=(const TspSolution& other) = delete;
+	TspSolution& operator=(const TspSolution& other);  // reuses own storage, both solutions must share config
 	TspSolution& operator=(TspSolution&& other) = delete;
 
 	template <class RandomGenerator>
@@ -28,18 +29,27 @@ public:
 	double getTotalDistance() const;
 	uint32_t getStepsNumTo(const uint32_t refCity, const uint32_t cityId) const;
 	uint32_t getIndexOfCityInChain(const uint32_t cityId) const;
+	uint64_t getTourHash() const;
 	void mutation();
 	TspSolution crossoverNrx(const double parent1Fitness, const TspSolution& parent2, const double parent2Fitness) const;
 	std::pair<TspSolution, TspSolution> crossoverPmx(const TspSolution& parent2) const;
+	std::pair<TspSolution, TspSolution> crossoverOx(const TspSolution& parent2) const;
+	std::pair<TspSolution, TspSolution> crossoverCx(const TspSolution& parent2) const;
+	TspSolution crossoverErx(const TspSolution& parent2) const;
 	std::string getStringRepresentation() const;
+	uint64_t getMemoryFootprint() const;  // heap bytes of city chain, as if it wasn't shared
 
 
 private:
+	std::vector<City>& materializeCityChain();
+	std::pair<uint32_t, uint32_t> drawPartitionIndices() const;
 	std::vector<City> pmx(const TspSolution& parent1,
 		const TspSolution& parent2, const uint32_t partitionIndex1, const uint32_t partitionIndex2) const;
+	std::vector<City> ox(const TspSolution& parent1,
+		const TspSolution& parent2, const uint32_t partitionIndex1, const uint32_t partitionIndex2) const;
 
 	const config::TtpConfig& ttpConfig;
-	std::vector<ttp::City> cityChain;
+	std::shared_ptr<std::vector<ttp::City>> sharedCityChain;  // copy on write, shared between clones
 };
 
 template <class RandomGenerator>
@@ -1,17 +1,103 @@
 #include "TtpIndividual.hpp"
 
+#include <algorithm>
 #include <memory>
 #include <utility>
 
+#include "BatchTripTimeEvaluator.hpp"
+#include "ExactPackingSolver.hpp"
+
 namespace ttp {
 
+namespace {
+
+struct PackingCandidate
+{
+	double score;
+	const Item* item;
+};
+
+struct PackingScratch
+{
+	std::vector<double> distanceToEnd;  // indexed by city id
+	std::vector<PackingCandidate> candidates;
+	std::vector<PackingCandidate> orderedCandidates;
+	std::vector<uint32_t> bucketsOffsets;
+};
+
+PackingScratch& getPackingScratch()
+{
+	thread_local PackingScratch scratch;
+	return scratch;
+}
+
+// bucket sort on score range, as many buckets as candidates, so expected linear time
+void orderByScoreDescending(const std::vector<PackingCandidate>& candidates,
+	std::vector<PackingCandidate>& ordered, std::vector<uint32_t>& bucketsOffsets)
+{
+	auto scoreDescending = [](const auto& lhs, const auto& rhs) {return lhs.score > rhs.score; };
+	ordered = candidates;
+	constexpr size_t minCandidatesNumForBuckets = 64u;
+	if (candidates.size() < minCandidatesNumForBuckets)
+	{
+		std::sort(ordered.begin(), ordered.end(), scoreDescending);
+		return;
+	}
+	auto [minIt, maxIt] = std::minmax_element(candidates.cbegin(), candidates.cend(),
+		[](const auto& lhs, const auto& rhs) {return lhs.score < rhs.score; });
+	const double maxScore = maxIt->score;
+	const double scoreRange = maxScore - minIt->score;
+	if (scoreRange <= 0.0)
+		return;
+	const auto bucketsNum = static_cast<uint32_t>(candidates.size());
+	const double bucketsPerScore = (bucketsNum - 1) / scoreRange;
+	auto bucketOf = [maxScore, bucketsPerScore, bucketsNum](const auto& candidate) {
+		return std::min(static_cast<uint32_t>((maxScore - candidate.score) * bucketsPerScore), bucketsNum - 1); };
+	bucketsOffsets.assign(bucketsNum + 1, 0u);
+	for (const auto& candidate : candidates)
+		bucketsOffsets[bucketOf(candidate) + 1]++;
+	for (auto bucket = 1u; bucket <= bucketsNum; bucket++)
+		bucketsOffsets[bucket] += bucketsOffsets[bucket - 1];
+	for (const auto& candidate : candidates)
+		ordered[bucketsOffsets[bucketOf(candidate)]++] = candidate;
+	// offsets now point at bucket ends
+	for (auto bucket = 0u, bucketBegin = 0u; bucket < bucketsNum; bucketBegin = bucketsOffsets[bucket++])
+	{
+		if (bucketsOffsets[bucket] - bucketBegin > 1)
+			std::sort(ordered.begin() + bucketBegin, ordered.begin() + bucketsOffsets[bucket], scoreDescending);
+	}
+}
+
+} // namespace
+
 TtpIndividual::TtpIndividual(const config::TtpConfig& ttpConfig, TspSolution&& tsp)
 	: ttpConfig(ttpConfig)
 	, tsp(std::move(tsp))
-	, knapsack(ttpConfig.capacityOfKnapsack)
+	, knapsack(ttpConfig.capacityOfKnapsack, static_cast<uint32_t>(ttpConfig.cities.size()))
+	, currentFitness(-std::numeric_limits<double>::infinity())
+	, isCurrentFitnessValid(false)
+	, isPackingFixed(false)
+{
+}
+
+TtpIndividual::TtpIndividual(const config::TtpConfig& ttpConfig, TspSolution&& tsp, Knapsack&& knapsack)
+	: ttpConfig(ttpConfig)
+	, tsp(std::move(tsp))
+	, knapsack(std::move(knapsack))
 	, currentFitness(-std::numeric_limits<double>::infinity())
 	, isCurrentFitnessValid(false)
+	, isPackingFixed(true)
+{
+}
+
+TtpIndividual& TtpIndividual::operator=(const TtpIndividual& other)
 {
+	tsp = other.tsp;
+	knapsack = other.knapsack;
+	currentFitness = other.currentFitness;
+	isCurrentFitnessValid = other.isCurrentFitnessValid;
+	isPackingFixed = other.isPackingFixed;
+	return *this;
 }
 
 double TtpIndividual::getTripTime() const
@@ -70,6 +156,26 @@ double TtpIndividual::getCurrentFitness() const
 	return currentFitness;
 }
 
+bool TtpIndividual::isEvaluated() const
+{
+	return isCurrentFitnessValid;
+}
+
+const std::vector<City>& TtpIndividual::getCityChain() const
+{
+	return tsp.getCityChain();
+}
+
+const Knapsack& TtpIndividual::getKnapsack() const
+{
+	return knapsack;
+}
+
+uint64_t TtpIndividual::getTourHash() const
+{
+	return tsp.getTourHash();
+}
+
 double TtpIndividual::evaluate()
 {
 	if (isCurrentFitnessValid)
@@ -78,13 +184,103 @@ double TtpIndividual::evaluate()
 	return computeAndSetFitness();
 }
 
+void TtpIndividual::evaluateAll(std::vector<std::unique_ptr<TtpIndividual>>& individuals)
+{
+	// knapsacks filled one by one, trip times computed for whole batch
+	thread_local std::vector<TtpIndividual*> toEvaluate;
+	thread_local std::vector<const std::vector<City>*> tours;
+	thread_local std::vector<const std::vector<uint32_t>*> weightsPerCity;
+	thread_local std::vector<double> tripTimes;
+	toEvaluate.clear();
+	tours.clear();
+	weightsPerCity.clear();
+	for (auto& individual : individuals)
+	{
+		if (individual->isCurrentFitnessValid)
+			continue;
+		if (!individual->isPackingFixed)
+			individual->fillKnapsack();
+		toEvaluate.push_back(individual.get());
+		tours.push_back(&individual->tsp.getCityChain());
+		weightsPerCity.push_back(&individual->knapsack.getWeightsPerCity());
+	}
+	if (toEvaluate.empty())
+		return;
+	const auto& ttpConfig = toEvaluate.front()->ttpConfig;
+	if (ttpConfig.evaluationPrecision == config::EvaluationPrecision::singlePrecision)
+		BatchTripTimeEvaluator<float>(ttpConfig).computeTripTimes(tours, weightsPerCity, tripTimes);
+	else
+		BatchTripTimeEvaluator<double>(ttpConfig).computeTripTimes(tours, weightsPerCity, tripTimes);
+	for (auto i = 0u; i < toEvaluate.size(); i++)
+	{
+		toEvaluate[i]->currentFitness = toEvaluate[i]->knapsack.getKnapsackValue() - tripTimes[i];
+		toEvaluate[i]->isCurrentFitnessValid = true;
+	}
+}
+
+void TtpIndividual::estimateFitnessAll(const std::vector<std::unique_ptr<TtpIndividual>>& individuals, std::vector<double>& estimates)
+{
+	thread_local std::vector<uint32_t> toEstimate;
+	thread_local std::vector<const std::vector<City>*> tours;
+	thread_local std::vector<const std::vector<uint32_t>*> weightsPerCity;
+	thread_local std::vector<double> tripTimes;
+	toEstimate.clear();
+	tours.clear();
+	weightsPerCity.clear();
+	estimates.resize(individuals.size());
+	for (auto i = 0u; i < individuals.size(); i++)
+	{
+		if (individuals[i]->isCurrentFitnessValid)
+		{
+			estimates[i] = individuals[i]->currentFitness;
+			continue;
+		}
+		toEstimate.push_back(i);
+		tours.push_back(&individuals[i]->tsp.getCityChain());
+		weightsPerCity.push_back(&individuals[i]->knapsack.getWeightsPerCity());
+	}
+	if (toEstimate.empty())
+		return;
+	const auto& ttpConfig = individuals[toEstimate.front()]->ttpConfig;
+	if (ttpConfig.evaluationPrecision == config::EvaluationPrecision::singlePrecision)
+		BatchTripTimeEvaluator<float>(ttpConfig).computeTripTimes(tours, weightsPerCity, tripTimes);
+	else
+		BatchTripTimeEvaluator<double>(ttpConfig).computeTripTimes(tours, weightsPerCity, tripTimes);
+	for (auto i = 0u; i < toEstimate.size(); i++)
+		estimates[toEstimate[i]] = individuals[toEstimate[i]]->knapsack.getKnapsackValue() - tripTimes[i];
+}
+
+void TtpIndividual::inheritPacking(const TtpIndividual& parent)
+{
+	knapsack = parent.knapsack;
+}
+
+bool TtpIndividual::packExactly(const uint64_t maxStates)
+{
+	if (ExactPackingSolver::countStates(ttpConfig) > maxStates)
+		return false;
+	const auto packing = ExactPackingSolver(ttpConfig).solve(tsp.getCityChain());
+	knapsack = packing;
+	isPackingFixed = true;
+	computeAndSetFitness();
+	return true;
+}
+
 double TtpIndividual::computeFitness()
 {
-	fillKnapsack();
-	return knapsack.getKnapsackValue() - getTripTime();
+	if (!isPackingFixed)
+		fillKnapsack();
+	return knapsack.getKnapsackValue() - computeTripTime();
 	//return tsp.getTotalDistance();
 }
 
+double TtpIndividual::computeTripTime() const
+{
+	if (ttpConfig.evaluationPrecision == config::EvaluationPrecision::singlePrecision)
+		return BatchTripTimeEvaluator<float>(ttpConfig).computeTripTime(tsp.getCityChain(), knapsack.getWeightsPerCity());
+	return getTripTime();
+}
+
 double TtpIndividual::computeAndSetFitness()
 {
 	auto fitness = computeFitness();
@@ -97,6 +293,7 @@ void TtpIndividual::mutation()
 {
 	tsp.mutation();
 	isCurrentFitnessValid = false;
+	isPackingFixed = false;
 }
 
 std::unique_ptr<TtpIndividual> TtpIndividual::crossoverNrx(const TtpIndividual& parent2) const
@@ -116,53 +313,73 @@ OffspringsPtrsPair TtpIndividual::crossoverPmx(const TtpIndividual& parent2) con
 	);
 }
 
+OffspringsPtrsPair TtpIndividual::crossoverOx(const TtpIndividual& parent2) const
+{
+	auto [offspringTsp1, offspringTsp2] = tsp.crossoverOx(parent2.tsp);
+	return std::make_pair(
+		std::make_unique<TtpIndividual>(ttpConfig, std::move(offspringTsp1)),
+		std::make_unique<TtpIndividual>(ttpConfig, std::move(offspringTsp2))
+	);
+}
+
+OffspringsPtrsPair TtpIndividual::crossoverCx(const TtpIndividual& parent2) const
+{
+	auto [offspringTsp1, offspringTsp2] = tsp.crossoverCx(parent2.tsp);
+	return std::make_pair(
+		std::make_unique<TtpIndividual>(ttpConfig, std::move(offspringTsp1)),
+		std::make_unique<TtpIndividual>(ttpConfig, std::move(offspringTsp2))
+	);
+}
+
+std::unique_ptr<TtpIndividual> TtpIndividual::crossoverErx(const TtpIndividual& parent2) const
+{
+	auto offspring = tsp.crossoverErx(parent2.tsp);
+	return std::make_unique<TtpIndividual>(ttpConfig, std::move(offspring));
+}
+
 std::string TtpIndividual::getStringRepresentation() const
 {
 	auto tspStr = tsp.getStringRepresentation();
-	auto knapsackStr = knapsack.getStringRepresentation();
+	auto knapsackStr = knapsack.getStringRepresentation(ttpConfig);
 	return "TSP: " + tspStr + "\n" + "knapsack: " + knapsackStr +
 		"\ntotal time: " + std::to_string(getTripTime()) + "\nfitness: " + std::to_string(currentFitness);
 }
 
+uint64_t TtpIndividual::getMemoryFootprint() const
+{
+	return sizeof(TtpIndividual) + tsp.getMemoryFootprint() + knapsack.getMemoryFootprint();
+}
+
 void TtpIndividual::fillKnapsack()
 {
 	knapsack.clear();
-	std::unordered_map<uint32_t, double> scorePerItemWithId;
-	scorePerItemWithId.reserve(ttpConfig.items.size());
-	std::unordered_map<uint32_t, double> totalTravelingDistanceFromCityWihId;
-	totalTravelingDistanceFromCityWihId.reserve(ttpConfig.cities.size());
+	auto& scratch = getPackingScratch();
 	const auto& cities = tsp.getCityChain();
-	totalTravelingDistanceFromCityWihId[cities[cities.size() - 1].index] = cities[cities.size() - 1].getDistance(cities[0]);
-	auto citiesNum = static_cast<int>(cities.size());
+	const auto citiesNum = static_cast<int>(cities.size());
+	scratch.distanceToEnd.resize(ttpConfig.cities.size() + 1);
+	scratch.distanceToEnd[cities[citiesNum - 1].index] = cities[citiesNum - 1].getDistance(cities[0]);
 	for (int i = citiesNum - 2; i >= 0; i--)
 	{
-		totalTravelingDistanceFromCityWihId[cities[i].index] =
-			cities[i].getDistance(cities[i + 1]) + totalTravelingDistanceFromCityWihId[cities[i + 1].index];
+		scratch.distanceToEnd[cities[i].index] =
+			cities[i].getDistance(cities[i + 1]) + scratch.distanceToEnd[cities[i + 1].index];
 	}
-	double totalTravellingTimeWithoutItems = totalTravelingDistanceFromCityWihId[cities[0].index] / ttpConfig.maxVelocity;
-	std::unordered_map<uint32_t, double> fitnessUtilization;
-	fitnessUtilization.reserve(ttpConfig.items.size());
-	for (const auto& item : ttpConfig.items)
+
+	// only items which pay off alone are candidates, items in city are ranked so the rest is skipped
+	scratch.candidates.clear();
+	for (auto cityId = 1u; cityId < ttpConfig.itemsPerCityOffsets.size() - 1; cityId++)
 	{
-		//auto timeFromCityWithOneItem = getTripTime(item.cityId, item.weight);
-		double velocity =
-			knapsack.getCurrentWeight() + item.weight >= knapsack.getKnapsackCapacity() ? ttpConfig.minVelocity : getCurrentVelocity(item.weight);
-		auto timeFromCityWithOneItem = totalTravelingDistanceFromCityWihId[item.cityId] / velocity;
-		auto totalTimeWithOneItem =
-			(totalTravelingDistanceFromCityWihId[cities[0].index] - totalTravelingDistanceFromCityWihId[item.cityId]) / ttpConfig.maxVelocity +
-			timeFromCityWithOneItem;
-		scorePerItemWithId[item.index] = item.profit - timeFromCityWithOneItem;
-		fitnessUtilization[item.index] = totalTravellingTimeWithoutItems + item.profit - totalTimeWithOneItem;
+		const double distanceToEnd = scratch.distanceToEnd[cityId];
+		const auto first = ttpConfig.rankedItemsPerCity.cbegin() + ttpConfig.itemsPerCityOffsets[cityId];
+		const auto last = ttpConfig.rankedItemsPerCity.cbegin() + ttpConfig.itemsPerCityOffsets[cityId + 1];
+		for (auto it = first; it != last && it->breakEvenDistance > distanceToEnd; ++it)
+			scratch.candidates.push_back(PackingCandidate{ it->item.profit - distanceToEnd * it->inverseVelocity, &it->item });
 	}
-	std::vector<Item> items = ttpConfig.items;
-	std::sort(items.begin(), items.end(),
-		[&scorePerItemWithId](const auto& lhs, const auto& rhs) {return scorePerItemWithId[lhs.index] > scorePerItemWithId[rhs.index]; });
-	for (const auto& item : items)
+	orderByScoreDescending(scratch.candidates, scratch.orderedCandidates, scratch.bucketsOffsets);
+
+	for (const auto& candidate : scratch.orderedCandidates)
 	{
-		if (knapsack.getCurrentWeight() + item.weight < knapsack.getKnapsackCapacity() && fitnessUtilization[item.index] > 0)
-		{
-			knapsack.addItem(item);
-		}
+		if (knapsack.getCurrentWeight() + candidate.item->weight < knapsack.getKnapsackCapacity())
+			knapsack.addItem(*candidate.item);
 		if (knapsack.getCurrentWeight() == knapsack.getKnapsackCapacity())
 			break;
 	}
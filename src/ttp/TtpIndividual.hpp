@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <vector>
 
 #include "TspSolution.hpp"
 
@@ -14,6 +15,8 @@ class TtpIndividual
 {
 public:
 	TtpIndividual(const config::TtpConfig& ttpConfig, TspSolution&& tsp);
+	// packing is kept as given instead of being filled greedily, until first mutation
+	TtpIndividual(const config::TtpConfig& ttpConfig, TspSolution&& tsp, Knapsack&& knapsack);
 
 	TtpIndividual() = delete;
 	TtpIndividual(const TtpIndividual&) = default;
@@ -21,7 +24,7 @@ public:
 	~TtpIndividual() = default;
 
 
-	TtpIndividual& operator=(const TtpIndividual&) = delete;
+	TtpIndividual& operator=(const TtpIndividual& other);  // reuses own storage, both individuals must share config
 	TtpIndividual& operator=(TtpIndividual&&) = delete;
 
 	template <class RandomGenerator>
@@ -31,14 +34,29 @@ public:
 	double getTripTime(const uint32_t startCityPos, const uint32_t weight) const;
 	double getCurrentVelocity(const uint32_t currentWeight) const;
 	double getCurrentFitness() const;
+	bool isEvaluated() const;  // current fitness matches current tour and packing
+	const std::vector<City>& getCityChain() const;
+	const Knapsack& getKnapsack() const;
+	uint64_t getTourHash() const;
 	double evaluate();
+	static void evaluateAll(std::vector<std::unique_ptr<TtpIndividual>>& individuals);
+	// cheap surrogate: trip time of current tour with current, possibly inherited, packing; exact for evaluated individuals
+	static void estimateFitnessAll(const std::vector<std::unique_ptr<TtpIndividual>>& individuals, std::vector<double>& estimates);
+	void inheritPacking(const TtpIndividual& parent);  // used by estimate only, packing is refilled by evaluation
+	// optimal packing for current tour, kept until mutation; false when instance has more packing states than maxStates
+	bool packExactly(const uint64_t maxStates);
 	void mutation();
 	std::unique_ptr<TtpIndividual> crossoverNrx(const TtpIndividual& parent2) const;
 	OffspringsPtrsPair crossoverPmx(const TtpIndividual& parent2) const;
+	OffspringsPtrsPair crossoverOx(const TtpIndividual& parent2) const;
+	OffspringsPtrsPair crossoverCx(const TtpIndividual& parent2) const;
+	std::unique_ptr<TtpIndividual> crossoverErx(const TtpIndividual& parent2) const;
 	std::string getStringRepresentation() const;
+	uint64_t getMemoryFootprint() const;  // bytes of individual with unshared tour and packing
 
 private:
 	double computeFitness();
+	double computeTripTime() const;  // in configured precision
 	double computeAndSetFitness();
 	void fillKnapsack();
 
@@ -47,6 +65,7 @@ private:
 	Knapsack knapsack;
 	double currentFitness;
 	bool isCurrentFitnessValid;
+	bool isPackingFixed;
 };
 
 template <class RandomGenerator>
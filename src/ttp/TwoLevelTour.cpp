@@ -0,0 +1,299 @@
+#include "TwoLevelTour.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ttp {
+
+namespace {
+
+constexpr uint32_t minSegmentSize = 8u;
+
+} // namespace
+
+TwoLevelTour::TwoLevelTour(const std::vector<City>& cityChain)
+	: citiesNum(static_cast<uint32_t>(cityChain.size()))
+	, segmentSize(std::max(minSegmentSize, static_cast<uint32_t>(std::sqrt(static_cast<double>(cityChain.size())))))
+	, head(cityChain.empty() ? 0u : cityChain.front().index)
+	, reversed(false)
+{
+	uint32_t maxCityId = 0u;
+	scratch.reserve(citiesNum);
+	for (const auto& city : cityChain)
+	{
+		maxCityId = std::max(maxCityId, city.index);
+		scratch.push_back(city.index);
+	}
+	nodes.resize(maxCityId + 1);
+	layOutSegments();
+}
+
+uint32_t TwoLevelTour::getCitiesNum() const
+{
+	return citiesNum;
+}
+
+uint32_t TwoLevelTour::getHead() const
+{
+	return head;
+}
+
+uint32_t TwoLevelTour::getNext(const uint32_t cityId) const
+{
+	return reversed ? internalPrev(cityId) : internalNext(cityId);
+}
+
+uint32_t TwoLevelTour::getPrev(const uint32_t cityId) const
+{
+	return reversed ? internalNext(cityId) : internalPrev(cityId);
+}
+
+bool TwoLevelTour::isBetween(const uint32_t from, const uint32_t cityId, const uint32_t to) const
+{
+	return reversed ? isInternallyBetween(to, cityId, from) : isInternallyBetween(from, cityId, to);
+}
+
+void TwoLevelTour::reversePath(const uint32_t from, const uint32_t to)
+{
+	if (from == to)
+		return;
+	if (head == from)
+		head = to;
+	if (reversed)
+		reverseInternalPath(to, from);
+	else
+		reverseInternalPath(from, to);
+	if (segments.size() > 4 * ((citiesNum + segmentSize - 1) / segmentSize))
+		rebuild();
+}
+
+std::vector<uint32_t> TwoLevelTour::getCityIds() const
+{
+	std::vector<uint32_t> cityIds;
+	cityIds.reserve(citiesNum);
+	for (auto i = 0u, cityId = head; i < citiesNum; i++, cityId = getNext(cityId))
+		cityIds.push_back(cityId);
+	return cityIds;
+}
+
+uint32_t TwoLevelTour::internalNext(const uint32_t cityId) const
+{
+	const auto& segment = segments[nodes[cityId].segment];
+	if (cityId == (segment.reversed ? segment.first : segment.last))
+	{
+		const auto& nextSegment = segments[segment.next];
+		return nextSegment.reversed ? nextSegment.last : nextSegment.first;
+	}
+	return segment.reversed ? nodes[cityId].prev : nodes[cityId].next;
+}
+
+uint32_t TwoLevelTour::internalPrev(const uint32_t cityId) const
+{
+	const auto& segment = segments[nodes[cityId].segment];
+	if (cityId == (segment.reversed ? segment.last : segment.first))
+	{
+		const auto& prevSegment = segments[segment.prev];
+		return prevSegment.reversed ? prevSegment.first : prevSegment.last;
+	}
+	return segment.reversed ? nodes[cityId].next : nodes[cityId].prev;
+}
+
+int64_t TwoLevelTour::getPositionInSegment(const uint32_t cityId) const
+{
+	const auto& node = nodes[cityId];
+	return segments[node.segment].reversed ? -static_cast<int64_t>(node.rank) : node.rank;
+}
+
+bool TwoLevelTour::isInternallyBetween(const uint32_t from, const uint32_t cityId, const uint32_t to) const
+{
+	// positions in the cycle compared as (segment rank, position in segment)
+	auto getPosition = [this](const uint32_t id) {
+		return static_cast<int64_t>(segments[nodes[id].segment].rank) * (int64_t{ 1 } << 33) + getPositionInSegment(id); };
+	const auto fromPos = getPosition(from);
+	const auto pos = getPosition(cityId);
+	const auto toPos = getPosition(to);
+	if (fromPos <= toPos)
+		return fromPos <= pos && pos <= toPos;
+	return pos >= fromPos || pos <= toPos;
+}
+
+bool TwoLevelTour::isInternallyFirst(const uint32_t cityId) const
+{
+	const auto& segment = segments[nodes[cityId].segment];
+	return cityId == (segment.reversed ? segment.last : segment.first);
+}
+
+void TwoLevelTour::reverseInternalPath(const uint32_t from, const uint32_t to)
+{
+	auto isWithinSegment = [this](const uint32_t first, const uint32_t last) {
+		return nodes[first].segment == nodes[last].segment && getPositionInSegment(first) <= getPositionInSegment(last); };
+	const auto complementFrom = internalNext(to);
+	const auto complementTo = internalPrev(from);
+	if (complementFrom == from)
+	{
+		reversed = !reversed;  // whole tour
+		return;
+	}
+	if (isWithinSegment(from, to))
+	{
+		reverseWithinSegment(from, to);
+		return;
+	}
+	// reversing complement gives the same cycle, mirrored
+	if (isWithinSegment(complementFrom, complementTo))
+	{
+		reverseWithinSegment(complementFrom, complementTo);
+		reversed = !reversed;
+		return;
+	}
+	auto first = from;
+	auto last = to;
+	const auto segmentsNum = static_cast<uint32_t>(segments.size());
+	const auto spannedNum = (segments[nodes[to].segment].rank + segmentsNum - segments[nodes[from].segment].rank) % segmentsNum + 1;
+	if (2 * spannedNum > segmentsNum + 1)
+	{
+		first = complementFrom;
+		last = complementTo;
+		reversed = !reversed;
+	}
+	splitBefore(first);
+	const auto afterLast = internalNext(last);
+	if (nodes[afterLast].segment == nodes[last].segment)
+		splitBefore(afterLast);
+	reverseSegments(nodes[first].segment, nodes[last].segment);
+}
+
+void TwoLevelTour::reverseWithinSegment(const uint32_t from, const uint32_t to)
+{
+	auto& segment = segments[nodes[from].segment];
+	const auto storedFirst = segment.reversed ? to : from;
+	const auto storedLast = segment.reversed ? from : to;
+	const auto before = storedFirst == segment.first ? none : nodes[storedFirst].prev;
+	const auto after = storedLast == segment.last ? none : nodes[storedLast].next;
+	const auto firstRank = nodes[storedFirst].rank;
+	scratch.clear();
+	for (auto cityId = storedFirst; ; cityId = nodes[cityId].next)
+	{
+		scratch.push_back(cityId);
+		if (cityId == storedLast)
+			break;
+	}
+	std::reverse(scratch.begin(), scratch.end());
+	const auto runSize = static_cast<uint32_t>(scratch.size());
+	for (auto i = 0u; i < runSize; i++)
+	{
+		auto& node = nodes[scratch[i]];
+		node.rank = firstRank + static_cast<int32_t>(i);
+		node.prev = i == 0 ? before : scratch[i - 1];
+		node.next = i + 1 == runSize ? after : scratch[i + 1];
+	}
+	if (before == none)
+		segment.first = scratch.front();
+	else
+		nodes[before].next = scratch.front();
+	if (after == none)
+		segment.last = scratch.back();
+	else
+		nodes[after].prev = scratch.back();
+}
+
+void TwoLevelTour::splitBefore(const uint32_t cityId)
+{
+	// stored list is cut between lastOfLeft and firstOfRight, smaller part moves to new segment
+	if (isInternallyFirst(cityId))
+		return;
+	const auto segmentId = nodes[cityId].segment;
+	const auto newSegmentId = static_cast<uint32_t>(segments.size());
+	const bool isReversed = segments[segmentId].reversed;
+	const auto lastOfLeft = isReversed ? cityId : nodes[cityId].prev;
+	const auto firstOfRight = isReversed ? nodes[cityId].next : cityId;
+	auto& segment = segments[segmentId];
+	const auto leftSize = static_cast<uint32_t>(nodes[lastOfLeft].rank - nodes[segment.first].rank + 1);
+	const bool moveLeft = 2 * leftSize <= segment.size;
+	Segment newSegment{ moveLeft ? segment.first : firstOfRight, moveLeft ? lastOfLeft : segment.last, none, none, 0u,
+		moveLeft ? leftSize : segment.size - leftSize, isReversed };
+	if (moveLeft)
+		segment.first = firstOfRight;
+	else
+		segment.last = lastOfLeft;
+	segment.size -= newSegment.size;
+	nodes[lastOfLeft].next = none;
+	nodes[firstOfRight].prev = none;
+	for (auto movedId = newSegment.first; movedId != none; movedId = nodes[movedId].next)
+		nodes[movedId].segment = newSegmentId;
+	// left part is internally first unless segment is reversed
+	if (moveLeft != isReversed)
+	{
+		newSegment.prev = segment.prev;
+		newSegment.next = segmentId;
+		segments[segment.prev].next = newSegmentId;
+		segment.prev = newSegmentId;
+	}
+	else
+	{
+		newSegment.prev = segmentId;
+		newSegment.next = segment.next;
+		segments[segment.next].prev = newSegmentId;
+		segment.next = newSegmentId;
+	}
+	segments.push_back(newSegment);
+	renumberSegments();
+}
+
+void TwoLevelTour::reverseSegments(const uint32_t firstSegment, const uint32_t lastSegment)
+{
+	const auto prevSegment = segments[firstSegment].prev;
+	const auto nextSegment = segments[lastSegment].next;
+	scratch.clear();
+	for (auto segmentId = firstSegment; ; segmentId = segments[segmentId].next)
+	{
+		scratch.push_back(segmentId);
+		if (segmentId == lastSegment)
+			break;
+	}
+	const auto runSize = static_cast<uint32_t>(scratch.size());
+	for (auto i = 0u; i < runSize / 2; i++)
+		std::swap(segments[scratch[i]].rank, segments[scratch[runSize - 1 - i]].rank);
+	for (const auto segmentId : scratch)
+	{
+		auto& segment = segments[segmentId];
+		std::swap(segment.next, segment.prev);
+		segment.reversed = !segment.reversed;
+	}
+	segments[lastSegment].prev = prevSegment;
+	segments[firstSegment].next = nextSegment;
+	segments[prevSegment].next = lastSegment;
+	segments[nextSegment].prev = firstSegment;
+}
+
+void TwoLevelTour::renumberSegments()
+{
+	auto segmentId = 0u;
+	for (auto rank = 0u; rank < segments.size(); rank++, segmentId = segments[segmentId].next)
+		segments[segmentId].rank = rank;
+}
+
+void TwoLevelTour::rebuild()
+{
+	scratch = getCityIds();
+	reversed = false;
+	layOutSegments();
+}
+
+void TwoLevelTour::layOutSegments()
+{
+	const auto segmentsNum = (citiesNum + segmentSize - 1) / segmentSize;
+	segments.clear();
+	for (auto segmentId = 0u; segmentId < segmentsNum; segmentId++)
+	{
+		const auto begin = segmentId * segmentSize;
+		const auto end = std::min(citiesNum, begin + segmentSize);
+		segments.push_back({ scratch[begin], scratch[end - 1], (segmentId + 1) % segmentsNum,
+			(segmentId + segmentsNum - 1) % segmentsNum, segmentId, end - begin, false });
+		for (auto pos = begin; pos < end; pos++)
+			nodes[scratch[pos]] = { pos + 1 == end ? none : scratch[pos + 1], pos == begin ? none : scratch[pos - 1],
+				segmentId, static_cast<int32_t>(pos - begin) };
+	}
+}
+
+} // namespace ttp
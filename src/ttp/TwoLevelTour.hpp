@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "City.hpp"
+
+namespace ttp {
+
+// Tour as two-level doubly linked list: cities are linked within segments of about sqrt(n) cities, segments are linked
+// in a cycle and carry a reversal bit. Next / prev / between queries are O(1), reversal of a path is O(sqrt(n)):
+// short paths inside one segment are relinked city by city, longer ones are cut at segment boundaries and whole
+// segments are flipped. The shorter of path and its complement is reversed, whole tour orientation is kept by one bit.
+// Splits add segments, all of them are rebuilt when their number grows fourfold, which keeps reversals amortized O(sqrt(n)).
+// Head is the city tour starts from, as the first city of TspSolution city chain.
+// Not used by solvers yet, only by TourStructureBenchmark: their moves are followed by an O(n) or O(segment) TTP
+// evaluation, which a faster reversal doesn't remove.
+class TwoLevelTour
+{
+public:
+	explicit TwoLevelTour(const std::vector<City>& cityChain);
+
+	TwoLevelTour() = delete;
+	TwoLevelTour(const TwoLevelTour&) = default;
+	TwoLevelTour(TwoLevelTour&&) = default;
+	~TwoLevelTour() = default;
+
+	TwoLevelTour& operator=(const TwoLevelTour&) = default;
+	TwoLevelTour& operator=(TwoLevelTour&&) = default;
+
+	uint32_t getCitiesNum() const;
+	uint32_t getHead() const;
+	uint32_t getNext(const uint32_t cityId) const;
+	uint32_t getPrev(const uint32_t cityId) const;
+	bool isBetween(const uint32_t from, const uint32_t cityId, const uint32_t to) const;  // cityId on path going forward from -> to
+	// path from -> to going forward becomes to -> from, as std::reverse on city chain; if path starts at head, its end
+	// becomes the head, head must not be inside the path otherwise
+	void reversePath(const uint32_t from, const uint32_t to);
+	std::vector<uint32_t> getCityIds() const;  // starting from head
+
+private:
+	struct Node
+	{
+		uint32_t next;  // within segment, in stored order
+		uint32_t prev;
+		uint32_t segment;
+		int32_t rank;  // increasing in stored order within segment
+	};
+
+	struct Segment
+	{
+		uint32_t first;  // in stored order
+		uint32_t last;
+		uint32_t next;  // in internal order of the cycle
+		uint32_t prev;
+		uint32_t rank;  // position in the cycle of segments
+		uint32_t size;
+		bool reversed;  // internal order of cities is last -> first
+	};
+
+	static constexpr uint32_t none = UINT32_MAX;
+
+	uint32_t internalNext(const uint32_t cityId) const;
+	uint32_t internalPrev(const uint32_t cityId) const;
+	int64_t getPositionInSegment(const uint32_t cityId) const;
+	bool isInternallyBetween(const uint32_t from, const uint32_t cityId, const uint32_t to) const;
+	bool isInternallyFirst(const uint32_t cityId) const;
+	void reverseInternalPath(const uint32_t from, const uint32_t to);
+	void reverseWithinSegment(const uint32_t from, const uint32_t to);
+	void splitBefore(const uint32_t cityId);
+	void reverseSegments(const uint32_t firstSegment, const uint32_t lastSegment);
+	void renumberSegments();
+	void rebuild();
+	void layOutSegments();  // from city ids in scratch
+
+	std::vector<Node> nodes;  // indexed by city id
+	std::vector<Segment> segments;
+	std::vector<uint32_t> scratch;
+	uint32_t citiesNum;
+	uint32_t segmentSize;  // target size of segments on rebuild
+	uint32_t head;
+	bool reversed;  // public orientation is opposite to internal one
+};
+
+} // namespace ttp
@@ -0,0 +1,197 @@
+#include "ParameterRace.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+
+#include <ga/GAlg.hpp>
+#include <ttp/TtpIndividual.hpp>
+#include <utils/Affinity.hpp>
+#include <utils/RandomUtils.hpp>
+#include <utils/StatisticsUtils.hpp>
+#include <utils/ThreadPool.hpp>
+
+namespace tuning {
+
+ParameterRace::ParameterRace(const config::TuningConfig& tuningConfig, const config::GAlgParams& baseParams,
+	const std::vector<config::TtpConfig>& instances, logging::Logger& logger)
+	: tuningConfig(tuningConfig)
+	, instances(instances)
+	, instanceReplicas(instances)
+	, threadsNum(tuningConfig.threadsNum != 0 ? tuningConfig.threadsNum : std::max(1u, std::thread::hardware_concurrency()))
+	, logger(logger)
+	, roundsNum(0u)
+{
+	if (instances.empty() || instances.size() != tuningConfig.instanceFilePaths.size())
+		throw std::runtime_error("Parameter race needs one loaded instance per tuning instance path");
+	if (tuningConfig.firstEliminationRound < 2)
+		throw std::runtime_error("First elimination round can't be lower than 2");
+	if (tuningConfig.significanceLevel <= 0.0 || tuningConfig.significanceLevel >= 1.0)
+		throw std::runtime_error("Significance level has to be in (0, 1)");
+	if (tuningConfig.runMaxPopulationsNum == 0 && tuningConfig.runMaxGAlgDuration == std::chrono::seconds::zero())
+		throw std::runtime_error("Tuning runs need generations or time limit");
+	createCandidates(baseParams);
+}
+
+void ParameterRace::run()
+{
+	while (roundsNum < tuningConfig.maxRounds && getAliveCandidates().size() > 1)
+	{
+		runRound();
+		eliminate();
+		std::cout << "round " << roundsNum << " (" << tuningConfig.instanceFilePaths[(roundsNum - 1) % tuningConfig.instanceFilePaths.size()] << "): "
+			<< getAliveCandidates().size() << " of " << candidates.size() << " candidates left" << std::endl;
+	}
+	double sumOfSquaredRanks = 0.0;
+	computeRankSums(getAliveCandidates(), sumOfSquaredRanks);  // survivors ranked among themselves
+	logRanking();
+}
+
+std::vector<ParameterRace::Candidate> ParameterRace::getRanking() const
+{
+	auto ranking = candidates;
+	std::stable_sort(ranking.begin(), ranking.end(), [](const auto& lhs, const auto& rhs) {
+		if (lhs.eliminationRound != rhs.eliminationRound)
+			return lhs.eliminationRound == 0 || (rhs.eliminationRound != 0 && lhs.eliminationRound > rhs.eliminationRound);
+		return lhs.meanRank < rhs.meanRank;
+	});
+	return ranking;
+}
+
+void ParameterRace::createCandidates(const config::GAlgParams& baseParams)
+{
+	auto orBase = [](const auto& values, const auto& baseValue) {
+		return values.empty() ? std::vector<std::decay_t<decltype(baseValue)>>{ baseValue } : values; };
+	for (const auto populationSize : orBase(tuningConfig.populationSizes, baseParams.populationSize))
+		for (const auto tournamentSize : orBase(tuningConfig.tournamentSizes, baseParams.tournamentSize))
+			for (const auto crossoverProb : orBase(tuningConfig.crossoverProbs, baseParams.crossoverProb))
+				for (const auto mutationProb : orBase(tuningConfig.mutationProbs, baseParams.mutationProb))
+					for (const auto& crossoverType : orBase(tuningConfig.crossoverTypes, baseParams.crossoverType))
+					{
+						auto params = baseParams;
+						params.populationSize = populationSize;
+						params.tournamentSize = tournamentSize;
+						params.crossoverProb = crossoverProb;
+						params.mutationProb = mutationProb;
+						params.crossoverType = crossoverType;
+						params.maxPopulationsNum = tuningConfig.runMaxPopulationsNum;
+						params.maxGAlgDuration = tuningConfig.runMaxGAlgDuration;
+						candidates.push_back(Candidate{ params, 0u, 0u, 0.0, 0.0 });
+					}
+	// GAlg constructor builds crossover and selection functions, so invalid values fail here and not on worker threads
+	logging::Logger validationLogger("");
+	for (const auto& candidate : candidates)
+		ga::GAlg<ttp::TtpIndividual> validatedAlg(candidate.params, nullptr, validationLogger);
+}
+
+void ParameterRace::runRound()
+{
+	// common random numbers: all candidates of a round start from the same stream, which makes blocks less noisy
+	const auto instanceIndex = roundsNum % instances.size();
+	const auto alive = getAliveCandidates();
+	const auto streamId = static_cast<uint64_t>(roundsNum) + 1;
+	fitnesses.emplace_back(candidates.size(), 0.0);
+	auto& roundFitnesses = fitnesses.back();
+	auto runCandidates = [this, instanceIndex, &alive, &roundFitnesses, streamId](const uint32_t first, const uint32_t step) {
+		utils::affinity::pinCurrentThread(first);
+		const auto& ttpConfig = instanceReplicas.get()[instanceIndex];  // read on every evaluation, so kept node-local
+		auto createRandomFun = [&ttpConfig]() {
+			return ttp::TtpIndividual::createRandom(ttpConfig, utils::rnd::Random::getInstance().getRndGen()); };
+		for (auto i = first; i < alive.size(); i += step)
+		{
+			utils::rnd::Random::getInstance().useStream(streamId);
+			logging::Logger runLogger("");  // per generation log isn't kept
+			ga::GAlg<ttp::TtpIndividual> gAlg(candidates[alive[i]].params, createRandomFun, runLogger);
+			gAlg.run();
+			roundFitnesses[alive[i]] = gAlg.getBestIndividual()->getCurrentFitness();
+		}
+	};
+	utils::runWorkers(std::min(threadsNum, static_cast<uint32_t>(alive.size())), runCandidates);
+	roundsNum++;
+	for (const auto id : alive)
+	{
+		auto& candidate = candidates[id];
+		candidate.meanFitness += (roundFitnesses[id] - candidate.meanFitness) / ++candidate.roundsNum;
+	}
+}
+
+void ParameterRace::eliminate()
+{
+	// Friedman test with Conover's post-hoc comparisons, as in F-race
+	const auto alive = getAliveCandidates();
+	const double k = static_cast<double>(alive.size());
+	const double m = static_cast<double>(roundsNum);
+	double sumOfSquaredRanks = 0.0;
+	const auto rankSums = computeRankSums(alive, sumOfSquaredRanks);
+	if (alive.size() < 2 || roundsNum < tuningConfig.firstEliminationRound)
+		return;
+
+	const double tiesCorrectedVariance = sumOfSquaredRanks - m * k * (k + 1) * (k + 1) / 4.0;
+	if (tiesCorrectedVariance <= 0.0)
+		return;  // all results tied
+	double statistic = 0.0;
+	for (const auto rankSum : rankSums)
+		statistic += (rankSum - m * (k + 1) / 2.0) * (rankSum - m * (k + 1) / 2.0);
+	statistic *= (k - 1) / tiesCorrectedVariance;
+	if (utils::stats::computeChiSquaredSurvival(statistic, k - 1) >= tuningConfig.significanceLevel)
+		return;
+
+	const double degreesOfFreedom = (m - 1) * (k - 1);
+	const double criticalDifference = utils::stats::computeStudentTQuantile(1.0 - tuningConfig.significanceLevel / 2.0, degreesOfFreedom) *
+		std::sqrt(std::max(0.0, 2.0 * m * (1.0 - statistic / (m * (k - 1))) * tiesCorrectedVariance / degreesOfFreedom));
+	const double bestRankSum = *std::min_element(rankSums.cbegin(), rankSums.cend());
+	for (auto j = 0u; j < alive.size(); j++)
+	{
+		if (rankSums[j] - bestRankSum > criticalDifference)
+			candidates[alive[j]].eliminationRound = roundsNum;
+	}
+}
+
+std::vector<double> ParameterRace::computeRankSums(const std::vector<uint32_t>& alive, double& sumOfSquaredRanks)
+{
+	// ranks within every round, among given candidates only
+	std::vector<double> rankSums(alive.size(), 0.0);
+	std::vector<double> negatedFitnesses(alive.size());
+	sumOfSquaredRanks = 0.0;
+	for (const auto& roundFitnesses : fitnesses)
+	{
+		for (auto j = 0u; j < alive.size(); j++)
+			negatedFitnesses[j] = -roundFitnesses[alive[j]];
+		const auto ranks = utils::stats::computeRanks(negatedFitnesses);
+		for (auto j = 0u; j < alive.size(); j++)
+		{
+			rankSums[j] += ranks[j];
+			sumOfSquaredRanks += ranks[j] * ranks[j];
+		}
+	}
+	for (auto j = 0u; j < alive.size() && roundsNum > 0; j++)
+		candidates[alive[j]].meanRank = rankSums[j] / roundsNum;
+	return rankSums;
+}
+
+std::vector<uint32_t> ParameterRace::getAliveCandidates() const
+{
+	std::vector<uint32_t> alive;
+	for (auto i = 0u; i < candidates.size(); i++)
+	{
+		if (candidates[i].eliminationRound == 0)
+			alive.push_back(i);
+	}
+	return alive;
+}
+
+void ParameterRace::logRanking() const
+{
+	logger.log("%s", "rank, population size, tournament size, crossover prob, mutation prob, crossover type, rounds, elimination round, mean rank, mean fitness");
+	auto position = 1u;
+	for (const auto& candidate : getRanking())
+	{
+		logger.log("%d, %d, %d, %.4f, %.4f, %s, %d, %d, %.4f, %.4f", position++, candidate.params.populationSize,
+			candidate.params.tournamentSize, candidate.params.crossoverProb, candidate.params.mutationProb,
+			candidate.params.crossoverType.c_str(), candidate.roundsNum, candidate.eliminationRound, candidate.meanRank, candidate.meanFitness);
+	}
+}
+
+} // namespace tuning
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <configuration/GAlgConfig.hpp>
+#include <configuration/TtpConfig.hpp>
+#include <configuration/TuningConfig.hpp>
+#include <logger/Logger.hpp>
+#include <utils/Affinity.hpp>
+
+namespace tuning {
+
+// F-race: every round all surviving candidates run GA once on the same instance with the same random stream, and
+// results are ranked within the round. From firstEliminationRound on, Friedman test over all rounds decides whether
+// candidates differ; if they do, candidates whose rank sum is worse than the best one by more than the post-hoc
+// critical difference are dropped. Race ends after maxRounds or when one candidate is left.
+class ParameterRace
+{
+public:
+	struct Candidate
+	{
+		config::GAlgParams params;
+		uint32_t roundsNum;  // rounds run
+		uint32_t eliminationRound;  // 0 for survivors
+		double meanRank;  // among survivors of its last test, 1 is best
+		double meanFitness;
+	};
+
+	ParameterRace(const config::TuningConfig& tuningConfig, const config::GAlgParams& baseParams,
+		const std::vector<config::TtpConfig>& instances, logging::Logger& logger);
+
+	ParameterRace() = delete;
+	ParameterRace(const ParameterRace&) = delete;
+	ParameterRace(ParameterRace&&) = delete;
+	~ParameterRace() = default;
+
+	ParameterRace& operator=(const ParameterRace&) = delete;
+	ParameterRace& operator=(ParameterRace&&) = delete;
+
+	void run();
+	std::vector<Candidate> getRanking() const;  // survivors by mean rank, then eliminated from the latest
+
+private:
+	void createCandidates(const config::GAlgParams& baseParams);
+	void runRound();
+	void eliminate();
+	std::vector<double> computeRankSums(const std::vector<uint32_t>& alive, double& sumOfSquaredRanks);  // also sets mean ranks
+	std::vector<uint32_t> getAliveCandidates() const;
+	void logRanking() const;
+
+	const config::TuningConfig tuningConfig;
+	const std::vector<config::TtpConfig>& instances;
+	utils::affinity::NodeReplicas<std::vector<config::TtpConfig>> instanceReplicas;
+	const uint32_t threadsNum;
+	std::vector<Candidate> candidates;
+	std::vector<std::vector<double>> fitnesses;  // [round][candidate], only alive candidates are filled
+	logging::Logger& logger;
+	uint32_t roundsNum;
+};
+
+} // namespace tuning
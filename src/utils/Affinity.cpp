@@ -0,0 +1,222 @@
+#include "Affinity.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#endif
+
+namespace utils {
+namespace affinity {
+
+namespace {
+
+constexpr std::size_t hugePageSize = 2u << 20;
+
+std::atomic<PinningPolicy> pinningPolicy{ PinningPolicy::none };
+std::atomic<bool> hugePagesEnabled{ false };
+thread_local uint32_t currentNode = 0u;
+
+// "0-3,8,10-11" as in sysfs cpulist files
+std::vector<uint32_t> parseCpuList(const std::string& cpuList)
+{
+	std::vector<uint32_t> cpus;
+	std::istringstream listStream(cpuList);
+	std::string range;
+	while (std::getline(listStream, range, ','))
+	{
+		const auto dashPos = range.find('-');
+		const auto first = static_cast<uint32_t>(std::stoul(range.substr(0, dashPos)));
+		const auto last = dashPos == std::string::npos ? first : static_cast<uint32_t>(std::stoul(range.substr(dashPos + 1)));
+		for (auto cpu = first; cpu <= last; cpu++)
+			cpus.push_back(cpu);
+	}
+	return cpus;
+}
+
+std::vector<std::vector<uint32_t>> readNodeCpus()
+{
+	std::vector<std::vector<uint32_t>> cpusPerNode;
+	for (auto node = 0u; ; node++)
+	{
+		std::ifstream cpuListFile("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+		std::string cpuList;
+		if (!cpuListFile.is_open() || !std::getline(cpuListFile, cpuList))
+			break;
+		cpusPerNode.push_back(cpuList.empty() ? std::vector<uint32_t>{} : parseCpuList(cpuList));
+	}
+	return cpusPerNode;
+}
+
+Topology detectTopology()
+{
+	Topology topology{ {}, false };
+#ifdef __linux__
+	cpu_set_t allowed;
+	CPU_ZERO(&allowed);
+	if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0)
+	{
+		for (auto& nodeCpus : readNodeCpus())
+		{
+			nodeCpus.erase(std::remove_if(nodeCpus.begin(), nodeCpus.end(), [&allowed](const auto cpu) {
+				return cpu >= CPU_SETSIZE || !CPU_ISSET(cpu, &allowed); }), nodeCpus.end());
+			if (!nodeCpus.empty())
+				topology.cpusPerNode.push_back(std::move(nodeCpus));
+		}
+		topology.isDetected = !topology.cpusPerNode.empty();
+	}
+#endif
+	if (!topology.isDetected)
+	{
+		topology.cpusPerNode.assign(1, std::vector<uint32_t>(std::max(1u, std::thread::hardware_concurrency())));
+		for (auto cpu = 0u; cpu < topology.cpusPerNode.front().size(); cpu++)
+			topology.cpusPerNode.front()[cpu] = cpu;
+	}
+	return topology;
+}
+
+Topology& getMutableTopology()
+{
+	static Topology topology = detectTopology();
+	return topology;
+}
+
+} // namespace
+
+std::string Topology::getStringRepresentation() const
+{
+	std::string representation = std::to_string(cpusPerNode.size()) + " NUMA node(s)" + (isDetected ? "" : " (not detected)");
+	for (auto node = 0u; node < cpusPerNode.size(); node++)
+	{
+		representation += "; node " + std::to_string(node) + ": " + std::to_string(cpusPerNode[node].size()) + " cpus (";
+		for (auto i = 0u; i < cpusPerNode[node].size(); i++)
+			representation += (i == 0 ? "" : ",") + std::to_string(cpusPerNode[node][i]);
+		representation += ")";
+	}
+	return representation;
+}
+
+uint32_t Topology::getCpusNum() const
+{
+	uint32_t cpusNum = 0u;
+	for (const auto& nodeCpus : cpusPerNode)
+		cpusNum += static_cast<uint32_t>(nodeCpus.size());
+	return cpusNum;
+}
+
+const Topology& getTopology()
+{
+	return getMutableTopology();
+}
+
+void setPinningPolicy(const PinningPolicy policy)
+{
+	pinningPolicy = policy;
+}
+
+PinningPolicy getPinningPolicy()
+{
+	return pinningPolicy;
+}
+
+void pinProcessToNode(const uint32_t node)
+{
+	auto& topology = getMutableTopology();
+	if (node >= topology.cpusPerNode.size())
+		throw std::runtime_error("NUMA node " + std::to_string(node) + " not available, nodes num: " + std::to_string(topology.cpusPerNode.size()));
+#ifdef __linux__
+	cpu_set_t nodeCpus;
+	CPU_ZERO(&nodeCpus);
+	for (const auto cpu : topology.cpusPerNode[node])
+		CPU_SET(cpu, &nodeCpus);
+	if (topology.isDetected && sched_setaffinity(0, sizeof(nodeCpus), &nodeCpus) != 0)
+		throw std::runtime_error("Could not pin process to NUMA node " + std::to_string(node));
+#endif
+	topology.cpusPerNode = { topology.cpusPerNode[node] };
+	currentNode = 0u;
+}
+
+uint32_t pinCurrentThread(const uint32_t workerId)
+{
+	const auto policy = getPinningPolicy();
+	if (policy == PinningPolicy::none)
+		return 0u;
+	const auto& topology = getTopology();
+	const auto nodesNum = static_cast<uint32_t>(topology.cpusPerNode.size());
+	uint32_t node = 0u;
+	uint32_t cpu = 0u;
+	if (policy == PinningPolicy::scatter)
+	{
+		node = workerId % nodesNum;
+		const auto& nodeCpus = topology.cpusPerNode[node];
+		cpu = nodeCpus[(workerId / nodesNum) % nodeCpus.size()];
+	}
+	else
+	{
+		auto slot = workerId % topology.getCpusNum();
+		while (slot >= topology.cpusPerNode[node].size())
+			slot -= static_cast<uint32_t>(topology.cpusPerNode[node++].size());
+		cpu = topology.cpusPerNode[node][slot];
+	}
+#ifdef __linux__
+	if (topology.isDetected)
+	{
+		cpu_set_t cpuSet;
+		CPU_ZERO(&cpuSet);
+		CPU_SET(cpu, &cpuSet);
+		pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);  // thread keeps running unpinned on failure
+	}
+#endif
+	static_cast<void>(cpu);
+	currentNode = node;
+	return node;
+}
+
+uint32_t getCurrentNode()
+{
+	return currentNode;
+}
+
+void setHugePagesEnabled(const bool enabled)
+{
+	hugePagesEnabled = enabled;
+}
+
+void adviseHugePages(const void* data, const std::size_t bytes)
+{
+	// only whole huge pages inside the buffer are advised, smaller buffers are skipped
+	if (!hugePagesEnabled)
+		return;
+#ifdef __linux__
+	const auto begin = (reinterpret_cast<std::uintptr_t>(data) + hugePageSize - 1) / hugePageSize * hugePageSize;
+	const auto end = (reinterpret_cast<std::uintptr_t>(data) + bytes) / hugePageSize * hugePageSize;
+	if (end > begin)
+		madvise(reinterpret_cast<void*>(begin), end - begin, MADV_HUGEPAGE);
+#else
+	static_cast<void>(data);
+	static_cast<void>(bytes);
+#endif
+}
+
+std::string getHugePagesMode()
+{
+	// selected mode is in brackets, e.g. "always [madvise] never"
+	std::ifstream modeFile("/sys/kernel/mm/transparent_hugepage/enabled");
+	std::string modes;
+	if (!modeFile.is_open() || !std::getline(modeFile, modes))
+		return "unavailable";
+	const auto open = modes.find('[');
+	const auto close = modes.find(']');
+	return open != std::string::npos && close != std::string::npos ? modes.substr(open + 1, close - open - 1) : modes;
+}
+
+}  // namespace affinity
+} // namespace utils
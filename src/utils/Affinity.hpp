@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace utils {
+namespace affinity {
+
+enum class PinningPolicy
+{
+	none,
+	compact,  // workers fill cpus of first NUMA node before going to the next one
+	scatter  // workers go round robin over NUMA nodes, so all memory controllers are used
+};
+
+// cpus usable by the process grouped by NUMA node, single node with all cpus when it can't be read
+struct Topology
+{
+	std::string getStringRepresentation() const;
+	uint32_t getCpusNum() const;
+
+	std::vector<std::vector<uint32_t>> cpusPerNode;
+	bool isDetected;  // read from sysfs, Linux only
+};
+
+// Settings are process wide and have to be set before workers start. Pinning is done on Linux only, elsewhere
+// threads stay unpinned and everything runs as on a single node. Pages are placed on first touch, so buffers allocated
+// by pinned workers land on their nodes.
+const Topology& getTopology();
+void setPinningPolicy(const PinningPolicy policy);
+PinningPolicy getPinningPolicy();
+void pinProcessToNode(const uint32_t node);  // restricts process and detected topology to cpus of given node
+uint32_t pinCurrentThread(const uint32_t workerId);  // returns node of the worker, no-op when policy is none
+uint32_t getCurrentNode();  // of calling thread, 0 for threads not pinned
+void setHugePagesEnabled(const bool enabled);
+void adviseHugePages(const void* data, const std::size_t bytes);  // transparent huge pages for big tables, when enabled
+std::string getHugePagesMode();  // system setting of transparent huge pages
+
+// Read-only data copied once per NUMA node by the first worker of that node which asks for it, so the copy is
+// allocated on its node. Without pinning, or on single node, the source itself is returned.
+template <class T>
+class NodeReplicas
+{
+public:
+	explicit NodeReplicas(const T& source);
+
+	NodeReplicas() = delete;
+	NodeReplicas(const NodeReplicas&) = delete;
+	NodeReplicas(NodeReplicas&&) = delete;
+	~NodeReplicas() = default;
+
+	NodeReplicas& operator=(const NodeReplicas&) = delete;
+	NodeReplicas& operator=(NodeReplicas&&) = delete;
+
+	const T& get();  // for node of calling thread
+
+private:
+	const T& source;
+	std::vector<std::unique_ptr<T>> replicas;  // indexed by node
+	std::vector<std::once_flag> replicated;
+};
+
+template <class T>
+NodeReplicas<T>::NodeReplicas(const T& source)
+	: source(source)
+	, replicas(getTopology().cpusPerNode.size())
+	, replicated(getTopology().cpusPerNode.size())
+{
+}
+
+template <class T>
+const T& NodeReplicas<T>::get()
+{
+	const auto node = getCurrentNode();
+	if (getPinningPolicy() == PinningPolicy::none || replicas.size() <= 1 || node >= replicas.size())
+		return source;
+	std::call_once(replicated[node], [this, node]() {replicas[node] = std::make_unique<T>(source); });
+	return *replicas[node];
+}
+
+} // namespace affinity
+} // namespace utils
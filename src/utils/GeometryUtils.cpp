@@ -0,0 +1,144 @@
+#include "GeometryUtils.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace utils {
+namespace geo {
+
+namespace {
+
+// position of cell (x, y) along Hilbert curve filling gridSide x gridSide grid, gridSide is power of 2
+uint64_t hilbertIndex(const uint32_t gridSide, uint32_t x, uint32_t y)
+{
+	uint64_t index = 0u;
+	for (uint32_t side = gridSide / 2; side > 0; side /= 2)
+	{
+		const uint32_t rx = (x & side) > 0;
+		const uint32_t ry = (y & side) > 0;
+		index += static_cast<uint64_t>(side) * side * ((3 * rx) ^ ry);
+		if (ry == 0)  // rotate quadrant
+		{
+			if (rx == 1)
+			{
+				x = side - 1 - x;
+				y = side - 1 - y;
+			}
+			std::swap(x, y);
+		}
+	}
+	return index;
+}
+
+struct BoundingSquare
+{
+	double minX;
+	double minY;
+	double side;
+};
+
+BoundingSquare computeBoundingSquare(const std::vector<ttp::City>& cities)
+{
+	auto [minXIt, maxXIt] = std::minmax_element(cities.cbegin(), cities.cend(), [](const auto& lhs, const auto& rhs) {return lhs.x < rhs.x; });
+	auto [minYIt, maxYIt] = std::minmax_element(cities.cbegin(), cities.cend(), [](const auto& lhs, const auto& rhs) {return lhs.y < rhs.y; });
+	return { minXIt->x, minYIt->y, std::max({ maxXIt->x - minXIt->x, maxYIt->y - minYIt->y, 1e-9 }) };
+}
+
+} // namespace
+
+std::vector<uint32_t> orderAlongHilbertCurve(const std::vector<ttp::City>& cities)
+{
+	if (cities.empty())
+		return {};
+	const auto square = computeBoundingSquare(cities);
+	constexpr uint32_t gridSide = 1u << 16;
+	auto toGrid = [&square](const double offset) {return std::min(static_cast<uint32_t>(offset / square.side * gridSide), gridSide - 1); };
+
+	std::vector<std::pair<uint64_t, uint32_t>> curvePositions;  // (hilbert index, id)
+	curvePositions.reserve(cities.size());
+	for (const auto& city : cities)
+		curvePositions.emplace_back(hilbertIndex(gridSide, toGrid(city.x - square.minX), toGrid(city.y - square.minY)), city.index);
+	std::sort(curvePositions.begin(), curvePositions.end());
+	std::vector<uint32_t> cityIds;
+	cityIds.reserve(cities.size());
+	for (const auto& curvePosition : curvePositions)
+		cityIds.push_back(curvePosition.second);
+	return cityIds;
+}
+
+std::vector<std::pair<uint32_t, double>> findNearestCities(const std::vector<ttp::City>& cities)
+{
+	// about 2 cities per cell; rings of cells around city are searched until they can't hold anything closer
+	const auto citiesNum = static_cast<uint32_t>(cities.size());
+	std::vector<std::pair<uint32_t, double>> nearest(citiesNum, { 1u, std::numeric_limits<double>::infinity() });
+	if (citiesNum < 2)
+		return nearest;
+	const auto square = computeBoundingSquare(cities);
+	const auto cellsPerSide = std::max(1u, static_cast<uint32_t>(std::sqrt(citiesNum / 2.0)));
+	const double cellSide = square.side / cellsPerSide;
+	auto toCell = [cellSide, cellsPerSide](const double offset) {
+		return std::min(static_cast<uint32_t>(offset / cellSide), cellsPerSide - 1); };
+	std::vector<uint32_t> cellOf(citiesNum);
+	std::vector<uint32_t> cellOffsets(cellsPerSide * cellsPerSide + 1, 0u);
+	for (auto i = 0u; i < citiesNum; i++)
+	{
+		cellOf[i] = toCell(cities[i].y - square.minY) * cellsPerSide + toCell(cities[i].x - square.minX);
+		cellOffsets[cellOf[i] + 1]++;
+	}
+	for (auto cell = 0u; cell < cellsPerSide * cellsPerSide; cell++)
+		cellOffsets[cell + 1] += cellOffsets[cell];
+	std::vector<uint32_t> citiesByCell(citiesNum);
+	auto insertPositions = cellOffsets;
+	for (auto i = 0u; i < citiesNum; i++)
+		citiesByCell[insertPositions[cellOf[i]]++] = i;
+
+	for (auto i = 0u; i < citiesNum; i++)
+	{
+		const auto cellX = static_cast<int64_t>(cellOf[i] % cellsPerSide);
+		const auto cellY = static_cast<int64_t>(cellOf[i] / cellsPerSide);
+		auto nearestPos = 0u;
+		auto minDistance = std::numeric_limits<double>::infinity();
+		auto searchCell = [&](const int64_t x, const int64_t y) {
+			if (x < 0 || y < 0 || x >= cellsPerSide || y >= cellsPerSide)
+				return;
+			const auto cell = static_cast<uint32_t>(y * cellsPerSide + x);
+			for (auto k = cellOffsets[cell]; k < cellOffsets[cell + 1]; k++)
+			{
+				const auto j = citiesByCell[k];
+				if (j == i)
+					continue;
+				const auto distance = cities[i].getDistance(cities[j]);
+				if (distance < minDistance || (distance == minDistance && j < nearestPos))
+				{
+					minDistance = distance;
+					nearestPos = j;
+				}
+			}
+		};
+		// cities in ring r are at least r - 1 cells away, slack covers rounding of cell assignment
+		for (int64_t ring = 0; ring <= cellsPerSide && (ring - 1) * cellSide <= minDistance + cellSide * 1e-9; ring++)
+		{
+			if (ring == 0)
+			{
+				searchCell(cellX, cellY);
+				continue;
+			}
+			for (auto x = cellX - ring; x <= cellX + ring; x++)
+			{
+				searchCell(x, cellY - ring);
+				searchCell(x, cellY + ring);
+			}
+			for (auto y = cellY - ring + 1; y <= cellY + ring - 1; y++)
+			{
+				searchCell(cellX - ring, y);
+				searchCell(cellX + ring, y);
+			}
+		}
+		nearest[i] = { cities[nearestPos].index, minDistance };
+	}
+	return nearest;
+}
+
+}  // namespace geo
+} // namespace utils
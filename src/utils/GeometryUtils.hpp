@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include <ttp/City.hpp>
+
+namespace utils {
+namespace geo {
+
+// ids of cities sorted by position along Hilbert curve laid over their bounding square, ties broken by id
+std::vector<uint32_t> orderAlongHilbertCurve(const std::vector<ttp::City>& cities);
+// (nearest city id, distance) for every city in vector order, ties broken by lower position in vector, (1, inf) for single city.
+// Cities are bucketed in uniform grid, so it is linear in cities num for not too clustered instances
+std::vector<std::pair<uint32_t, double>> findNearestCities(const std::vector<ttp::City>& cities);
+
+}  // namespace geo
+} // namespace utils
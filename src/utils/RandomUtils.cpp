@@ -1,45 +1,223 @@
 #include "RandomUtils.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <random>
+
 namespace utils {
 namespace rnd {
 
+namespace {
+
+uint64_t splitMix64(uint64_t& x)
+{
+	uint64_t z = (x += 0x9e3779b97f4a7c15ull);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+	return z ^ (z >> 31);
+}
+
+uint64_t rotl(const uint64_t x, const int k)
+{
+	return (x << k) | (x >> (64 - k));
+}
+
+constexpr double doubleUnit = 1.0 / 9007199254740992.0;  // 2^-53
+
+// threshold compared with raw 64-bit output, 2^64 * probability clamped to representable values
+uint64_t bernoulliThreshold(const double probability)
+{
+	if (probability <= 0.0)
+		return 0u;
+	if (probability >= 1.0)
+		return std::numeric_limits<uint64_t>::max();
+	return static_cast<uint64_t>(probability * 18446744073709551616.0);
+}
+
+uint64_t makeNondeterministicSeed()
+{
+	std::random_device rd;
+	return (static_cast<uint64_t>(rd()) << 32) | rd();
+}
+
+// threads which never call useStream get ids disjoint from the ones set explicitly
+constexpr uint64_t defaultStreamsMask = 1ull << 63;
+
+std::atomic<uint64_t> globalSeed{ makeNondeterministicSeed() };
+std::atomic<uint64_t> nextDefaultStreamId{ 0u };
+
+} // namespace
+
+Xoshiro256StarStar::Xoshiro256StarStar(const uint64_t seed, const uint64_t streamId)
+{
+	this->seed(seed, streamId);
+}
+
+Xoshiro256StarStar::result_type Xoshiro256StarStar::operator()()
+{
+	const uint64_t result = rotl(state[1] * 5, 7) * 9;
+	const uint64_t t = state[1] << 17;
+	state[2] ^= state[0];
+	state[3] ^= state[1];
+	state[1] ^= state[2];
+	state[0] ^= state[3];
+	state[2] ^= t;
+	state[3] = rotl(state[3], 45);
+	return result;
+}
+
+void Xoshiro256StarStar::seed(const uint64_t seed, const uint64_t streamId)
+{
+	uint64_t streamMix = streamId;
+	uint64_t x = seed ^ splitMix64(streamMix);
+	for (auto& s : state)
+		s = splitMix64(x);
+}
+
 Random& Random::getInstance()
 {
-	static Random instance;
+	thread_local Random instance;
 	return instance;
 }
 
+void Random::setGlobalSeed(const uint64_t seed)
+{
+	globalSeed = seed;
+	getInstance().useStream(0u);
+}
+
+uint64_t Random::getGlobalSeed()
+{
+	return globalSeed;
+}
+
+void Random::useStream(const uint64_t streamId)
+{
+	gen.seed(globalSeed, streamId);
+}
+
 uint32_t Random::getRandomUint(const uint32_t min, const uint32_t max)
 {
-	std::uniform_int_distribution<uint32_t>::param_type distParam(min, max);
-	uintDis.param(distParam);
-	return uintDis(gen);
+	return min + getBoundedUint(max - min + 1u);
 }
 
 int32_t Random::getRandomInt(const int32_t min, const int32_t max)
 {
-	std::uniform_int_distribution<int32_t>::param_type distParam(min, max);
-	intDis.param(distParam);
-	return intDis(gen);
+	auto range = static_cast<uint32_t>(static_cast<int64_t>(max) - min + 1);
+	return static_cast<int32_t>(static_cast<int64_t>(min) + getBoundedUint(range));
 }
 
 double Random::getRandomDouble(const double min, const double max)
 {
-	std::uniform_real_distribution<double>::param_type distParam(min, max);
-	doubleDis.param(distParam);
-	return doubleDis(gen);
+	return min + (max - min) * ((gen() >> 11) * doubleUnit);
+}
+
+bool Random::getBernoulli(const double probability)
+{
+	return gen() < bernoulliThreshold(probability);
+}
+
+void Random::fillRandomUints(uint32_t* out, const std::size_t count, const uint32_t min, const uint32_t max)
+{
+	const uint32_t range = max - min + 1u;
+	if (range == 0u)  // full 32-bit range
+	{
+		for (auto i = 0u; i < count; i++)
+			out[i] = static_cast<uint32_t>(gen() >> 32);
+		return;
+	}
+	rawBuffer.resize(count);
+	for (auto& raw : rawBuffer)
+		raw = gen();
+	// Lemire's multiply-shift, biased candidates are rare and redrawn afterwards
+	const uint32_t threshold = (0u - range) % range;
+	std::size_t rejected = 0u;
+	for (std::size_t i = 0u; i < count; i++)
+	{
+		uint64_t m = (rawBuffer[i] >> 32) * range;
+		out[i] = min + static_cast<uint32_t>(m >> 32);
+		rejected += static_cast<uint32_t>(m) < threshold;
+	}
+	if (rejected == 0u)
+		return;
+	for (std::size_t i = 0u; i < count; i++)
+	{
+		if (static_cast<uint32_t>((rawBuffer[i] >> 32) * range) < threshold)
+			out[i] = min + getBoundedUint(range);
+	}
+}
+
+void Random::fillRandomDoubles(double* out, const std::size_t count, const double min, const double max)
+{
+	rawBuffer.resize(count);
+	for (auto& raw : rawBuffer)
+		raw = gen();
+	const double scale = (max - min) * doubleUnit;
+	for (std::size_t i = 0u; i < count; i++)
+		out[i] = min + static_cast<double>(rawBuffer[i] >> 11) * scale;
 }
 
-std::mt19937 & Random::getRndGen()
+void Random::fillBernoulli(uint8_t* out, const std::size_t count, const double probability)
+{
+	rawBuffer.resize(count);
+	for (auto& raw : rawBuffer)
+		raw = gen();
+	const uint64_t threshold = bernoulliThreshold(probability);
+	for (std::size_t i = 0u; i < count; i++)
+		out[i] = rawBuffer[i] < threshold;
+}
+
+RandomEngine& Random::getRndGen()
 {
 	return gen;
 }
 
 Random::Random()
-	: rd()
-	, gen(rd())
+	: gen(globalSeed, defaultStreamsMask | nextDefaultStreamId++)
+{
+}
+
+uint32_t Random::getBoundedUint(const uint32_t range)
+{
+	// Lemire's nearly divisionless method, range == 0 stands for full 32-bit range
+	if (range == 0u)
+		return static_cast<uint32_t>(gen() >> 32);
+	uint64_t m = (gen() >> 32) * range;
+	auto low = static_cast<uint32_t>(m);
+	if (low < range)
+	{
+		const uint32_t threshold = (0u - range) % range;
+		while (low < threshold)
+		{
+			m = (gen() >> 32) * range;
+			low = static_cast<uint32_t>(m);
+		}
+	}
+	return static_cast<uint32_t>(m >> 32);
+}
+
+BernoulliBatch::BernoulliBatch(const double probability, const std::size_t batchSize)
+	: probability(probability)
+	, draws(batchSize == 0u ? 1u : batchSize)
+	, position(draws.size())
+{
+}
+
+bool BernoulliBatch::next()
+{
+	if (position == draws.size())
+	{
+		Random::getInstance().fillBernoulli(draws.data(), draws.size(), probability);
+		position = 0u;
+	}
+	return draws[position++] != 0u;
+}
+
+void BernoulliBatch::setProbability(const double probability)
 {
+	this->probability = probability;
+	position = draws.size();
 }
 
 } // namespace rnd
-} // namespace utils
\ No newline at end of file
+} // namespace utils
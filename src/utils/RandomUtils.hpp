@@ -1,16 +1,42 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
-#include <random>
+#include <limits>
+#include <vector>
 
 namespace utils {
 namespace rnd {
 
-// This util class is NOT thread-safe
+// xoshiro256** generator, state initialized with splitmix64 from (seed, stream) pair,
+// so that every stream id gives independent sequence for the same seed
+class Xoshiro256StarStar final
+{
+public:
+	using result_type = uint64_t;
+
+	Xoshiro256StarStar(const uint64_t seed, const uint64_t streamId);
+
+	static constexpr result_type min() { return std::numeric_limits<result_type>::min(); }
+	static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+	result_type operator()();
+	void seed(const uint64_t seed, const uint64_t streamId);
+
+private:
+	uint64_t state[4];
+};
+
+using RandomEngine = Xoshiro256StarStar;
+
+// One instance per thread, each of them is NOT thread-safe on its own.
+// For results independent of threads scheduling, every job should call useStream with its own id
 class Random final
 {
 public:
 	static Random& getInstance();
+	static void setGlobalSeed(const uint64_t seed);  // also restarts calling thread's instance at stream 0
+	static uint64_t getGlobalSeed();
 
 	Random(const Random&) = delete;
 	Random(Random&&) = delete;
@@ -18,19 +44,39 @@ public:
 	void operator=(const Random&) = delete;
 	void operator=(Random&&) = delete;
 
-	uint32_t getRandomUint(const uint32_t min, const uint32_t max);
-	int32_t getRandomInt(const int32_t min, const int32_t max);
-	double getRandomDouble(const double min, const double max);
-	std::mt19937& getRndGen();
+	void useStream(const uint64_t streamId);
+	uint32_t getRandomUint(const uint32_t min, const uint32_t max);  // closed range [min, max]
+	int32_t getRandomInt(const int32_t min, const int32_t max);  // closed range [min, max]
+	double getRandomDouble(const double min, const double max);  // half-open range [min, max)
+	bool getBernoulli(const double probability);
+	// bulk versions, raw engine output is generated first and transformed in separate, vectorisable loops
+	void fillRandomUints(uint32_t* out, const std::size_t count, const uint32_t min, const uint32_t max);
+	void fillRandomDoubles(double* out, const std::size_t count, const double min, const double max);
+	void fillBernoulli(uint8_t* out, const std::size_t count, const double probability);
+	RandomEngine& getRndGen();
 
 private:
 	Random();
 
-	std::random_device rd;
-	std::mt19937 gen;
-	std::uniform_int_distribution<uint32_t> uintDis;
-	std::uniform_int_distribution<int32_t> intDis;
-	std::uniform_real_distribution<double> doubleDis;
+	uint32_t getBoundedUint(const uint32_t range);
+
+	RandomEngine gen;
+	std::vector<uint64_t> rawBuffer;
+};
+
+// Bernoulli trials drawn in bulk and consumed one by one, refilled from calling thread's Random when exhausted
+class BernoulliBatch final
+{
+public:
+	BernoulliBatch(const double probability, const std::size_t batchSize);
+
+	bool next();
+	void setProbability(const double probability);  // drops trials drawn with previous probability
+
+private:
+	double probability;
+	std::vector<uint8_t> draws;
+	std::size_t position;
 };
 
 } // namespace rnd
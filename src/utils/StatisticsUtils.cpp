@@ -0,0 +1,173 @@
+#include "StatisticsUtils.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+
+namespace utils {
+namespace stats {
+
+namespace {
+
+constexpr uint32_t maxIterations = 300u;
+constexpr double epsilon = 1e-14;
+constexpr double tiny = 1e-300;
+
+// regularized lower incomplete gamma P(a, x), series for x < a + 1, continued fraction otherwise
+double computeRegularizedGammaP(const double a, const double x)
+{
+	if (x <= 0.0)
+		return 0.0;
+	const double logPrefix = a * std::log(x) - x - std::lgamma(a);
+	if (x < a + 1.0)
+	{
+		double term = 1.0 / a;
+		double sum = term;
+		for (auto n = 1u; n < maxIterations && std::abs(term) > std::abs(sum) * epsilon; n++)
+		{
+			term *= x / (a + n);
+			sum += term;
+		}
+		return sum * std::exp(logPrefix);
+	}
+	double b = x + 1.0 - a;
+	double c = 1.0 / tiny;
+	double d = 1.0 / b;
+	double fraction = d;
+	for (auto n = 1u; n < maxIterations; n++)
+	{
+		const double an = -(n * (n - a));
+		b += 2.0;
+		d = an * d + b;
+		d = std::abs(d) < tiny ? tiny : d;
+		c = b + an / c;
+		c = std::abs(c) < tiny ? tiny : c;
+		d = 1.0 / d;
+		const double delta = d * c;
+		fraction *= delta;
+		if (std::abs(delta - 1.0) < epsilon)
+			break;
+	}
+	return 1.0 - std::exp(logPrefix) * fraction;
+}
+
+// continued fraction part of regularized incomplete beta, converges for x < (a + 1) / (a + b + 2)
+double computeBetaContinuedFraction(const double a, const double b, const double x)
+{
+	double c = 1.0;
+	double d = 1.0 - (a + b) * x / (a + 1.0);
+	d = std::abs(d) < tiny ? tiny : d;
+	d = 1.0 / d;
+	double fraction = d;
+	for (auto m = 1u; m < maxIterations; m++)
+	{
+		const double evenCoefficient = m * (b - m) * x / ((a + 2.0 * m - 1.0) * (a + 2.0 * m));
+		d = 1.0 + evenCoefficient * d;
+		d = std::abs(d) < tiny ? tiny : d;
+		c = 1.0 + evenCoefficient / c;
+		c = std::abs(c) < tiny ? tiny : c;
+		d = 1.0 / d;
+		fraction *= d * c;
+		const double oddCoefficient = -(a + m) * (a + b + m) * x / ((a + 2.0 * m) * (a + 2.0 * m + 1.0));
+		d = 1.0 + oddCoefficient * d;
+		d = std::abs(d) < tiny ? tiny : d;
+		c = 1.0 + oddCoefficient / c;
+		c = std::abs(c) < tiny ? tiny : c;
+		d = 1.0 / d;
+		const double delta = d * c;
+		fraction *= delta;
+		if (std::abs(delta - 1.0) < epsilon)
+			break;
+	}
+	return fraction;
+}
+
+double computeRegularizedBeta(const double a, const double b, const double x)
+{
+	if (x <= 0.0)
+		return 0.0;
+	if (x >= 1.0)
+		return 1.0;
+	const double logPrefix = std::lgamma(a + b) - std::lgamma(a) - std::lgamma(b) + a * std::log(x) + b * std::log(1.0 - x);
+	if (x < (a + 1.0) / (a + b + 2.0))
+		return std::exp(logPrefix) * computeBetaContinuedFraction(a, b, x) / a;
+	return 1.0 - std::exp(logPrefix) * computeBetaContinuedFraction(b, a, 1.0 - x) / b;
+}
+
+double computeStudentTCdf(const double t, const double degreesOfFreedom)
+{
+	const double tail = 0.5 * computeRegularizedBeta(degreesOfFreedom / 2.0, 0.5, degreesOfFreedom / (degreesOfFreedom + t * t));
+	return t >= 0.0 ? 1.0 - tail : tail;
+}
+
+} // namespace
+
+std::vector<double> computeRanks(const std::vector<double>& values)
+{
+	std::vector<size_t> order(values.size());
+	std::iota(order.begin(), order.end(), 0u);
+	std::sort(order.begin(), order.end(), [&values](const auto lhs, const auto rhs) {return values[lhs] < values[rhs]; });
+	std::vector<double> ranks(values.size());
+	for (size_t runBegin = 0u; runBegin < order.size();)
+	{
+		auto runEnd = runBegin + 1;
+		while (runEnd < order.size() && values[order[runEnd]] == values[order[runBegin]])
+			runEnd++;
+		const double averageRank = (runBegin + 1 + runEnd) / 2.0;
+		for (auto i = runBegin; i < runEnd; i++)
+			ranks[order[i]] = averageRank;
+		runBegin = runEnd;
+	}
+	return ranks;
+}
+
+double computeSpearmanCorrelation(const std::vector<double>& xs, const std::vector<double>& ys)
+{
+	if (xs.size() != ys.size() || xs.size() < 2)
+		return 0.0;
+	const auto xRanks = computeRanks(xs);
+	const auto yRanks = computeRanks(ys);
+	const double meanRank = (xs.size() + 1) / 2.0;
+	double covariance = 0.0;
+	double xVariance = 0.0;
+	double yVariance = 0.0;
+	for (size_t i = 0u; i < xs.size(); i++)
+	{
+		covariance += (xRanks[i] - meanRank) * (yRanks[i] - meanRank);
+		xVariance += (xRanks[i] - meanRank) * (xRanks[i] - meanRank);
+		yVariance += (yRanks[i] - meanRank) * (yRanks[i] - meanRank);
+	}
+	if (xVariance == 0.0 || yVariance == 0.0)
+		return 0.0;
+	return covariance / std::sqrt(xVariance * yVariance);
+}
+
+double computeChiSquaredSurvival(const double x, const double degreesOfFreedom)
+{
+	return 1.0 - computeRegularizedGammaP(degreesOfFreedom / 2.0, x / 2.0);
+}
+
+double computeStudentTQuantile(const double probability, const double degreesOfFreedom)
+{
+	// bisection on monotonic cdf, bracket grown until it holds the quantile
+	double low = -1.0;
+	double high = 1.0;
+	while (computeStudentTCdf(low, degreesOfFreedom) > probability && low > -std::numeric_limits<double>::max() / 4)
+		low *= 2.0;
+	while (computeStudentTCdf(high, degreesOfFreedom) < probability && high < std::numeric_limits<double>::max() / 4)
+		high *= 2.0;
+	for (auto i = 0u; i < 200u && high - low > 1e-12 * std::max(1.0, std::abs(high)); i++)
+	{
+		const double middle = (low + high) / 2.0;
+		if (computeStudentTCdf(middle, degreesOfFreedom) < probability)
+			low = middle;
+		else
+			high = middle;
+	}
+	return (low + high) / 2.0;
+}
+
+} // namespace stats
+} // namespace utils
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <vector>
+
+
+namespace utils {
+namespace stats {
+
+std::vector<double> computeRanks(const std::vector<double>& values);  // 1-based, ties get average rank
+double computeSpearmanCorrelation(const std::vector<double>& xs, const std::vector<double>& ys);  // 0 when undefined
+double computeChiSquaredSurvival(const double x, const double degreesOfFreedom);  // P(X >= x)
+double computeStudentTQuantile(const double probability, const double degreesOfFreedom);  // probability in (0, 1)
+
+}  // namespace stats
+} // namespace utils
@@ -1,5 +1,7 @@
 #include "StringUtils.hpp"
 
+#include <sstream>
+
 namespace utils {
 namespace str {
 
@@ -20,5 +22,15 @@ std::string& rtrim(std::string& s, const char* whitespaces)
 	return ltrim(rtrim(s, whitespaces), whitespaces);
 }
 
+std::vector<std::string> split(const std::string& s)
+{
+	std::istringstream stream(s);
+	std::vector<std::string> tokens;
+	std::string token;
+	while (stream >> token)
+		tokens.push_back(token);
+	return tokens;
+}
+
 } // namespace str
 } // namespace utils
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 
 namespace utils {
@@ -9,6 +10,7 @@ namespace str {
 std::string& ltrim(std::string& s, const char* whitespaces = " \t\n\r\f\v");
 std::string& rtrim(std::string& s, const char* whitespaces = " \t\n\r\f\v");
 std::string& trim(std::string& s, const char* whitespaces = " \t\n\r\f\v");
+std::vector<std::string> split(const std::string& s);  // on whitespace, empty tokens are skipped
 
 }  // namespace str
 } // namespace utils
@@ -0,0 +1,94 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <exception>
+
+#include "Affinity.hpp"
+
+namespace utils {
+
+void runWorkers(const uint32_t workersNum, const std::function<void(const uint32_t worker, const uint32_t workersNum)>& workerFun)
+{
+	if (workersNum <= 1)
+	{
+		workerFun(0u, 1u);
+		return;
+	}
+	std::vector<std::exception_ptr> workerErrors(workersNum);
+	std::vector<std::thread> workers;
+	workers.reserve(workersNum);
+	for (auto worker = 0u; worker < workersNum; worker++)
+	{
+		workers.emplace_back([&workerFun, &workerErrors, worker, workersNum]() {
+			try
+			{
+				workerFun(worker, workersNum);
+			}
+			catch (...)
+			{
+				workerErrors[worker] = std::current_exception();
+			}
+		});
+	}
+	for (auto& worker : workers)
+		worker.join();
+	for (const auto& error : workerErrors)
+	{
+		if (error != nullptr)
+			std::rethrow_exception(error);
+	}
+}
+
+ThreadPool::ThreadPool(const uint32_t threadsNum)
+	: stopping(false)
+{
+	const auto workersNum = threadsNum != 0 ? threadsNum : std::max(1u, std::thread::hardware_concurrency());
+	workers.reserve(workersNum);
+	for (auto i = 0u; i < workersNum; i++)
+		workers.emplace_back([this, i]() {workerLoop(i); });
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(jobsMutex);
+		stopping = true;
+	}
+	jobsCondition.notify_all();
+	for (auto& worker : workers)
+		worker.join();
+}
+
+void ThreadPool::submit(std::function<void(void)> job)
+{
+	{
+		std::lock_guard<std::mutex> lock(jobsMutex);
+		jobs.push_back(std::move(job));
+	}
+	jobsCondition.notify_one();
+}
+
+uint32_t ThreadPool::getThreadsNum() const
+{
+	return static_cast<uint32_t>(workers.size());
+}
+
+void ThreadPool::workerLoop(const uint32_t workerId)
+{
+	affinity::pinCurrentThread(workerId);
+	while (true)
+	{
+		std::function<void(void)> job;
+		{
+			std::unique_lock<std::mutex> lock(jobsMutex);
+			jobsCondition.wait(lock, [this]() {return stopping || !jobs.empty(); });
+			if (jobs.empty())
+				return;
+			job = std::move(jobs.front());
+			jobs.pop_front();
+		}
+		job();
+	}
+}
+
+} // namespace utils
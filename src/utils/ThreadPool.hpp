@@ -0,0 +1,45 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+namespace utils {
+
+// Runs workerFun(worker, workersNum) for every worker in its own thread, or on calling thread when there is at most one;
+// joins all of them, then rethrows error of the lowest numbered failed worker
+void runWorkers(const uint32_t workersNum, const std::function<void(const uint32_t worker, const uint32_t workersNum)>& workerFun);
+
+// Fixed number of workers taking jobs in submission order; destructor finishes queued jobs before joining
+class ThreadPool
+{
+public:
+	explicit ThreadPool(const uint32_t threadsNum);  // 0 indicates all hardware threads
+
+	ThreadPool() = delete;
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool(ThreadPool&&) = delete;
+	~ThreadPool();
+
+	ThreadPool& operator=(const ThreadPool&) = delete;
+	ThreadPool& operator=(ThreadPool&&) = delete;
+
+	void submit(std::function<void(void)> job);
+	uint32_t getThreadsNum() const;
+
+private:
+	void workerLoop(const uint32_t workerId);
+
+	std::vector<std::thread> workers;
+	std::deque<std::function<void(void)>> jobs;
+	std::mutex jobsMutex;
+	std::condition_variable jobsCondition;
+	bool stopping;
+};
+
+} // namespace utils